@@ -16,6 +16,7 @@
 #include "lost/Camera2D.h"
 #include "lost/MeshAlgo.h"
 #include "lost/Mesh.h"
+#include "lost/HybridBuffer.h"
 #include "lost/Material.h"
 #include "lost/Bitmap.h"
 #include "lost/Texture.h"
@@ -267,6 +268,7 @@ void BezierEd::startup()
   nv.resize(numInterpolatedPoints);
 
   bezier = newTriangleStrip((numInterpolatedPoints*2)-2);
+  bezier->vertexBuffer->usage = GL_DYNAMIC_DRAW; // rewritten whenever a control point moves
   bezier->material->blendPremultiplied();
   bezier->material->shader=textureShader;
   bezier->material->color = whiteColor;
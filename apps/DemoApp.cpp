@@ -134,6 +134,7 @@ void DemoApp::startup()
   ResourceBundle mainBundle;
   colorShader = resourceManager->shader("resources/glsl/color");
   textureShader = resourceManager->shader("resources/glsl/texture");
+  textShader = resourceManager->shader("resources/glsl/text");
   hblurShader = resourceManager->shader("resources/glsl/hblur");
   vblurShader = resourceManager->shader("resources/glsl/vblur");
 
@@ -169,18 +170,18 @@ void DemoApp::startup()
   tb.reset();
   tb.renderAllPhysicalLines(rt2);
   rt2->material->blendPremultiplied();
-  rt2->material->shader = textureShader;
+  rt2->material->shader = textShader;
   rt2->transform = Matrix::translate(Vec3(200,200,0));
 
   rt1 = render("I vant to drink your blood!", font, false);
-  rt1->material->shader = textureShader;
+  rt1->material->shader = textShader;
   rt1->material->blendPremultiplied();
   rt1->transform = Matrix::translate(Vec3(50,50,0));
 
   u32string utf32s;
   utf32s = 0xf085;
   rt3 = render(utf32s, fa, false);
-  rt3->material->shader = textureShader;
+  rt3->material->shader = textShader;
   rt3->material->color = yellowColor;
   rt3->material->blendPremultiplied();
   rt3->transform = Matrix::translate(Vec3(600,300,0));
@@ -235,6 +236,7 @@ void DemoApp::startup()
   controlPoints.push_back(Vec2(110,410));
 
   triangulatedSpline = newTriangleStrip((numInterpolatedPoints*2)-2);
+  triangulatedSpline->vertexBuffer->usage = GL_DYNAMIC_DRAW; // rewritten every frame
   triangulatedSpline->material->blendPremultiplied();
   triangulatedSpline->material->shader=textureShader;
   
@@ -371,7 +373,7 @@ void DemoApp::update()
   
   //////////////////////
   // screen pass
-  glBindFramebuffer(GL_FRAMEBUFFER, 0); // switch to default framebuffer
+  glContext->bindDefaultFramebuffer();
 
 
 // light blue  glContext->clearColor(Color(.45, .84, 1, 1));
@@ -382,9 +384,10 @@ void DemoApp::update()
 
 //  glContext->draw(coloredQuad);
 //  glContext->draw(texturedQuad);
-  glContext->draw(rt1);
-  glContext->draw(rt2);
-  glContext->draw(rt3);
+  // text meshes don't overlap, so they share a depth and can be sorted by texture
+  glContext->enqueue(rt1);
+  glContext->enqueue(rt2);
+  glContext->enqueue(rt3);
 //  glContext->draw(dot);
 //  glContext->draw(dot2);
 //  glContext->draw(lines);
@@ -393,11 +396,12 @@ void DemoApp::update()
 
 //  glContext->draw(triangulatedSpline);
 
-    glContext->draw(triangulatedSpline);
+    glContext->enqueue(triangulatedSpline, 1);
 
     fb0quad->material->shader = textureShader;
     fb0quad->material->color = Color(1,1,1,1);
-    glContext->draw(fb0quad);
+    glContext->enqueue(fb0quad, 2);
+    glContext->flush();
 
 
 /*  for(uint32_t i=0; i<ipdots.size(); ++i)
@@ -21,6 +21,7 @@ struct DemoApp : Application
   MeshPtr texturedQuad;
   ShaderProgramPtr colorShader;
   ShaderProgramPtr textureShader;
+  ShaderProgramPtr textShader;
   ShaderProgramPtr hblurShader;
   ShaderProgramPtr vblurShader;
   
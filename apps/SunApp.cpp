@@ -280,6 +280,11 @@ void SunApp::update()
 
 void SunApp::shutdown()
 {
+  // give the canvas textures back while the Context still exists
+  canvasQuad.reset();
+  offscreenCanvas.reset();
+  hblurCanvas.reset();
+  vblurCanvas.reset();
 }
 
 }
@@ -65,6 +65,7 @@ void Application::doStartup()
 void Application::doUpdate()
 {
   clock.update();
+  glContext->beginFrame();
   update();
   ui->update(eventQueue->getCurrentQueue());
   eventQueue->swap();
@@ -77,6 +78,7 @@ void Application::doShutdown()
   ui->disable();
   // Application shutdown
   delete glContext;
+  glContext = NULL; // GL objects that are still referenced, e.g. by canvases, check this when they're destroyed
 }
 
 
@@ -521,4 +521,96 @@ void Bitmap::premultiplyAlpha()
   }
 }
 
+static const float distanceInfinity = 1e20f;
+
+// squared euclidean distance transform of a sampled function in one dimension, see
+// Felzenszwalb, Huttenlocher: Distance Transforms of Sampled Functions
+static void distanceTransform1d(const vector<float>& f, vector<float>& d, vector<int>& v, vector<float>& z, int n)
+{
+  int k = 0;
+  v[0] = 0;
+  z[0] = -distanceInfinity;
+  z[1] = distanceInfinity;
+  for(int q=1; q<n; ++q)
+  {
+    float s = ((f[q]+q*q)-(f[v[k]]+v[k]*v[k]))/(2*q-2*v[k]);
+    while(s <= z[k])
+    {
+      --k;
+      s = ((f[q]+q*q)-(f[v[k]]+v[k]*v[k]))/(2*q-2*v[k]);
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k+1] = distanceInfinity;
+  }
+  k = 0;
+  for(int q=0; q<n; ++q)
+  {
+    while(z[k+1] < q) { ++k; }
+    d[q] = (q-v[k])*(q-v[k]) + f[v[k]];
+  }
+}
+
+// grid holds 0 for pixels of the shape and distanceInfinity for all others, receives the squared distance to the shape
+static void distanceTransform2d(vector<float>& grid, int width, int height)
+{
+  int n = std::max(width, height);
+  vector<float> f(n), d(n), z(n+1);
+  vector<int> v(n);
+  for(int x=0; x<width; ++x)
+  {
+    for(int y=0; y<height; ++y) { f[y] = grid[y*width+x]; }
+    distanceTransform1d(f, d, v, z, height);
+    for(int y=0; y<height; ++y) { grid[y*width+x] = d[y]; }
+  }
+  for(int y=0; y<height; ++y)
+  {
+    for(int x=0; x<width; ++x) { f[x] = grid[y*width+x]; }
+    distanceTransform1d(f, d, v, z, width);
+    for(int x=0; x<width; ++x) { grid[y*width+x] = d[x]; }
+  }
+}
+
+void Bitmap::signedDistanceField(float spread)
+{
+  ASSERT(format == GL_ALPHA, "signed distance fields can only be calculated for GL_ALPHA bitmaps");
+  int w = (int)width;
+  int h = (int)height;
+  int numPixels = w*h;
+  if(numPixels == 0) { return; }
+  
+  vector<float> outside(numPixels); // distance of pixels outside the shape to the nearest pixel inside
+  vector<float> inside(numPixels); // and vice versa
+  for(int i=0; i<numPixels; ++i)
+  {
+    bool in = data[i] >= 128;
+    outside[i] = in ? 0 : distanceInfinity;
+    inside[i] = in ? distanceInfinity : 0;
+  }
+  distanceTransform2d(outside, w, h);
+  distanceTransform2d(inside, w, h);
+  
+  for(int i=0; i<numPixels; ++i)
+  {
+    float coverage = data[i]/255.0f;
+    float distance; // positive outside
+    if((coverage > 0.0f) && (coverage < 1.0f))
+    {
+      // antialiased edge pixels know more about the edge than the distance transform
+      distance = .5f - coverage;
+    }
+    else if(coverage >= .5f)
+    {
+      distance = .5f - sqrtf(inside[i]);
+    }
+    else
+    {
+      distance = sqrtf(outside[i]) - .5f;
+    }
+    float value = .5f - distance/(2*spread);
+    data[i] = (uint8_t)(std::min(std::max(value, 0.0f), 1.0f)*255.0f + .5f);
+  }
+}
+
 }
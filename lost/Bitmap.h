@@ -189,6 +189,14 @@ namespace lost
     
     void premultiplyAlpha(); // multiplies each pixels color channels with its alpha channel.
     
+    /** replaces the coverage of a GL_ALPHA bitmap with a signed distance field.
+     * 128 is the edge of the shape, values rise to 255 inside and fall to 0 outside within spread pixels.
+     * Leave at least spread pixels of empty border around the shape.
+     *
+     * @param spread  distance in pixels that is covered by the value range.
+     */
+    void signedDistanceField(float spread);
+    
   private:
     DISALLOW_COPY_AND_ASSIGN(Bitmap);
     void destroy();
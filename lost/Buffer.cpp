@@ -24,6 +24,7 @@ namespace lost
   {
     glGenBuffers(1, &buffer);GLASSERT;
     numElements = 0;
+    capacity = 0;
   }
 
    Buffer::~Buffer()
@@ -35,7 +36,7 @@ namespace lost
    void Buffer::bind() { Buffer::bind(target); }
    void Buffer::bufferData(GLsizeiptr size, const GLvoid* data, GLenum usage) {Buffer::bufferData(target, size, data, usage);}
    void Buffer::bindBufferData(GLsizeiptr size, const GLvoid* data, GLenum usage) {bind();Buffer::bufferData(target, size, data, usage);}
-   void Buffer::bufferSubData(GLintptr offset,GLsizeiptr sizeInBytes,	const GLvoid* data) {Buffer::bufferSubData(target, offset, size, data);};
+   void Buffer::bufferSubData(GLintptr offset,GLsizeiptr sizeInBytes,	const GLvoid* data) {Buffer::bufferSubData(target, offset, sizeInBytes, data);};
    void Buffer::bindBufferSubData(GLintptr offset,GLsizeiptr size,	const GLvoid* data) {bind(); Buffer::bufferSubData(target, offset, size, data);};
 
    void Buffer::drawArrays(GLenum mode, GLint first, GLsizei count)
@@ -70,6 +71,7 @@ namespace lost
    void Buffer::bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
   {
     glBufferData(target, size, data, usage);GLASSERT;
+    capacity = size;
   }
 
    void Buffer::bufferSubData(GLenum  	target,
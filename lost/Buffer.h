@@ -26,6 +26,7 @@ struct Buffer
   GLint size;
   GLenum type;
   unsigned long numElements; // number of verts/colors/texcoords in array
+  GLsizeiptr capacity; // size in bytes of the storage created by the last bufferData call
 
   Buffer();
   virtual ~Buffer();
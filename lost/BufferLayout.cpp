@@ -183,71 +183,49 @@ GLenum   glScalarTypeForElementType(ElementType et)
 
 uint32_t BufferLayout::numScalarsForUsageType(UsageType ut)
 {
-  ElementType et = ut2et[ut];
-  return numScalarsForElementType(et);
+  return numScalarsForElementType(entries[ut].elementType);
 }  
   
-void BufferLayout::updatePointerConfigs()
+void BufferLayout::update()
 {
-  ut2apc.clear();
+  for(uint32_t i=0; i<UT_count; ++i)
+  {
+    entries[i] = BufferLayoutEntry();
+  }
+  
+  _size = 0;
   for(uint32_t i=0; i<attributes.size(); ++i)
   {
-    UsageType ut = attributes[i].usageType;
-    AttributePointerConfig apc;
-    apc.size = numScalarsForUsageType(ut);
-    apc.type = glScalarTypeFromUsageType(ut);
-    apc.stride = stride(ut);
-    apc.offset = (GLvoid*)offset(ut);
-    apc.normalise = attributes[i].normalise;
-    ut2apc[ut] = apc;
+    BufferLayoutEntry& entry = entries[attributes[i].usageType];
+    entry.used = true;
+    entry.elementType = attributes[i].elementType;
+    entry.offset = _size;
+    entry.size = attributes[i].size();
+    _size += entry.size;
   }
-}
-
-void BufferLayout::add(ElementType elementType, UsageType usageType)
-{
-  attributes.push_back(BufferLayoutAttribute(elementType, usageType));
-  ut2et[usageType] = elementType;
-  updatePointerConfigs();
-}
- 
-// size of the whole layout in bytes, without taking partitioning into account, in bytes
-uint32_t BufferLayout::size() const
-{
-  uint32_t result = 0;
+  
+  // pointer configs need the final stride
   for(uint32_t i=0; i<attributes.size(); ++i)
   {
-    result += attributes[i].size();
+    BufferLayoutEntry& entry = entries[attributes[i].usageType];
+    entry.apc.size = numScalarsForElementType(entry.elementType);
+    entry.apc.type = glScalarTypeForElementType(entry.elementType);
+    entry.apc.stride = _size;
+    entry.apc.offset = (GLvoid*)(size_t)entry.offset;
+    entry.apc.normalise = attributes[i].normalise;
   }
-  return result;
 }
 
-bool BufferLayout::hasUsageType(UsageType ut)
+void BufferLayout::add(ElementType elementType, UsageType usageType)
 {
-  map<UsageType, ElementType>::iterator pos = ut2et.find(ut);
-  return (pos != ut2et.end());
+  ASSERT(usageType < UT_count, "invalid UsageType "<<usageType);
+  attributes.push_back(BufferLayoutAttribute(elementType, usageType));
+  update();
 }
 
 GLenum BufferLayout::glScalarTypeFromUsageType(UsageType ut)
 {
-  return glScalarTypeForElementType(ut2et[ut]);
-}
-
-uint32_t BufferLayout::stride(UsageType ut)
-{
-  return size();
-}
-
-size_t BufferLayout::offset(UsageType ut)
-{
-  size_t result = 0;
-  
-  for(uint32_t i=0; i<attributes.size(); ++i)
-  {
-    if(attributes[i].usageType == ut) break;
-    result += attributes[i].size();
-  }
-  
-  return result;
+  return glScalarTypeForElementType(entries[ut].elementType);
 }
 
 }
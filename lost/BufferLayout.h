@@ -91,6 +91,7 @@ const static UsageType UT_vertexAttrib12 = 33;
 const static UsageType UT_vertexAttrib13 = 34; 
 const static UsageType UT_vertexAttrib14 = 35; 
 const static UsageType UT_vertexAttrib15 = 36; 
+const static UsageType UT_count = 37; // number of usage types, not a usage type itself
 
 const char* nameForElementType(ElementType et);
 const char* nameForUsageType(UsageType ut);
@@ -119,28 +120,42 @@ struct AttributePointerConfig
   GLboolean normalise;
 };
 
+// everything BufferLayout knows about a single usage type, precalculated by BufferLayout::add
+struct BufferLayoutEntry
+{
+  BufferLayoutEntry() : used(false), elementType(0), offset(0), size(0) {}
+
+  bool                    used; // false if the layout has no attribute with this usage type, all other members are invalid then
+  ElementType             elementType;
+  uint32_t                offset; // in bytes, from the start of a vertex
+  uint32_t                size; // in bytes
+  AttributePointerConfig  apc;
+};
+
 struct BufferLayout
 {
-  // FIXME: add caching for various size and partition parameters so we don'T have to recalculate on every set call
-  // add maps that hold these values. Update maps upon each add call.
+  BufferLayout() : _size(0) {}
+
   vector<BufferLayoutAttribute> attributes;
-  map<UsageType, ElementType> ut2et;
-  map<UsageType, AttributePointerConfig> ut2apc;
+  BufferLayoutEntry entries[UT_count]; // indexed by UsageType, recalculated on each add call
   
-  void updatePointerConfigs();
   void add(ElementType elementType, UsageType usageType);
    
   // size of the whole layout in bytes, without taking partitioning into account, in bytes
-  uint32_t size() const;
+  uint32_t size() const { return _size; }
   uint32_t numScalarsForUsageType(UsageType ut);
-//  uint32_t structSize() const;
   
-  const AttributePointerConfig& pointerConfigForUsageType(UsageType ut) { return ut2apc[ut]; };
+  const AttributePointerConfig& pointerConfigForUsageType(UsageType ut) const { return entries[ut].apc; };
+  ElementType elementType(UsageType ut) const { return entries[ut].elementType; }
   
-  bool hasUsageType(UsageType ut);
+  bool hasUsageType(UsageType ut) const { return (ut < UT_count) && entries[ut].used; }
   GLenum glScalarTypeFromUsageType(UsageType ut);
-  uint32_t stride(UsageType ut);
-  size_t offset(UsageType ut);
+  uint32_t stride(UsageType ut) const { return _size; }
+  size_t offset(UsageType ut) const { return entries[ut].offset; }
+  
+private:
+  uint32_t _size;
+  void update(); // recalculates entries and size from attributes
 };
 
 } // lost
@@ -5,6 +5,7 @@
 #include "lost/FrameBuffer.h"
 #include "lost/Context.h"
 #include "lost/Quad.h"
+#include "lost/RenderTargetPool.h"
 
 namespace lost
 {
@@ -14,12 +15,17 @@ namespace lost
     size = sz;
     cam = Camera2D::create(Rect(0,0,size.width,size.height));
 
-    framebuffer = FrameBuffer::create(size, GL_RGBA);
-    framebuffer->check();
-    Application::instance()->glContext->bindDefaultFramebuffer();
+    // exact size, since effects like blurs sample with fixed texture coordinate offsets
+    _pool = Context::instance()->renderTargetPool;
+    framebuffer = _pool->framebuffer(_pool->borrow(size, true));
 
     clearColor = Color(0,0,0,0);
   }
+  
+  Canvas::~Canvas()
+  {
+    _pool->giveBack(texture());
+  }
 
   void Canvas::drawToCanvas(const std::function<void(void)>& sceneFunc)
   {
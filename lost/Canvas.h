@@ -7,6 +7,7 @@ namespace lost
 struct Canvas
 {
   Canvas(const Vec2& sz);
+  virtual ~Canvas();
   
   // drawing to a canvas leaves the framebuffer enabled, so you have to switch to the default buffer after calling drawToCanvas()
   virtual void drawToCanvas(const std::function<void(void)>& sceneFunc);
@@ -17,6 +18,9 @@ struct Canvas
   CameraPtr cam;
   FrameBufferPtr framebuffer;
   Color clearColor;
+  
+private:
+  RenderTargetPoolPtr _pool; // the texture came from here. not taken from the Context on destruction, canvases might outlive it
 };
 
 }
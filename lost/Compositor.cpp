@@ -9,6 +9,7 @@
 #include "lost/layers/Layer.h"
 #include "lost/FrameBuffer.h"
 #include "lost/Context.h"
+#include "lost/RenderTargetPool.h"
 
 namespace lost
 {
@@ -16,9 +17,9 @@ namespace lost
 Compositor::Compositor()
 {
   drawContext = new DrawContext(Application::instance()->glContext);
-  fb.reset(new FrameBuffer);
   fbcam.reset(new Camera2D(Rect(0, 0, 0, 0)));
   uicam.reset(new Camera2D(Rect(0, 0, 0, 0)));
+  generation = 1;
 }
 
 Compositor::~Compositor()
@@ -32,20 +33,22 @@ void Compositor::layerDying(Layer* layer)
   // remove from all containers that don't own layer to prevent dangling pointers
   // remove cache to improve resource usage
   
-  // redrawCandidates
-  auto pos = find(redrawCandidates.begin(), redrawCandidates.end(), layer);
-  if(pos != redrawCandidates.end())
+  // only layers that were scheduled in the current frame can be in redrawCandidates or redraws
+  if(layer->redrawGeneration == generation)
   {
-    redrawCandidates.erase(pos);
-    DOUT("removing layer from redrawCandidates: "<<layer->name);
-  }
+    auto pos = find(redrawCandidates.begin(), redrawCandidates.end(), layer);
+    if(pos != redrawCandidates.end())
+    {
+      redrawCandidates.erase(pos);
+      DOUT("removing layer from redrawCandidates: "<<layer->name);
+    }
 
-  // redraws
-  auto pos2 = find(redraws.begin(), redraws.end(), layer);
-  if(pos2 != redraws.end())
-  {
-    redraws.erase(pos2);
-    DOUT("removing layer from redraws: "<<layer->name);
+    auto pos2 = find(redraws.begin(), redraws.end(), layer);
+    if(pos2 != redraws.end())
+    {
+      redraws.erase(pos2);
+      DOUT("removing layer from redraws: "<<layer->name);
+    }
   }
 
   clearCacheForLayer(layer);
@@ -55,10 +58,21 @@ void Compositor::reset()
 {
   redrawCandidates.clear();
   redraws.clear();
+  ++generation;
+  RenderTargetPool* pool = drawContext->glContext->renderTargetPool.get();
+  for(auto i : layerCache)
+  {
+    pool->giveBack(i.second);
+  }
   layerCache.clear();
-  fb->bind();
-  fb->detachAll();
-  drawContext->glContext->bindDefaultFramebuffer();
+  for(auto i : contentCache)
+  {
+    pool->giveBack(i.second);
+  }
+  contentCache.clear();
+  pool->giveBack(drawBuffer);
+  drawBuffer.reset();
+  pool->purge();
 }
 
 void Compositor::clearCacheForLayer(Layer* layer)
@@ -66,9 +80,11 @@ void Compositor::clearCacheForLayer(Layer* layer)
   auto pos = layerCache.find(layer);
   if(pos != layerCache.end())
   {
+    drawContext->glContext->renderTargetPool->giveBack(pos->second);
     layerCache.erase(pos);
 //    DOUT("removing cache for layer: "<<layer->name);
   }
+  clearContentCache(layer);
 }
   
 void Compositor::windowResized(const Vec2& newSize)
@@ -84,6 +100,7 @@ void Compositor::draw(const LayerPtr& rootLayer)
   
   redrawCandidates.clear();
   redraws.clear();
+  ++generation;
 }
 
 #pragma mark - uncached draw -
@@ -107,29 +124,25 @@ void Compositor::unchachedDraw(Vec2 pos, const LayerPtr& layer)
 void Compositor::drawLayer(const Vec2& globalLayerOrigin, const LayerPtr& layer)
 {
   numDraws++;
-  // create framebuffer texture if required
-  if(!drawBuffer)
-  {
-    drawBuffer.reset(new Texture);
-  }
-  drawBuffer->init(layer->rect().size());
+  // reuse the framebuffer texture as long as the layer fits
+  RenderTargetPool* pool = drawContext->glContext->renderTargetPool.get();
+  drawBuffer = pool->resize(drawBuffer, layer->rect().size());
 
   // setup framebuffer and camera
-  fb->bind();
-  fb->detachAll();
-  fb->attachColorBuffer(0, drawBuffer);
-  fb->check(); // FIXME: remove this once it is not needed anymore for debugging
+  pool->bind(drawBuffer);
   fbcam->viewport(Rect(0,0,layer->rect().size()));
   drawContext->glContext->camera(fbcam);
 
   // draw layer into texture
   layer->draw(drawContext);
 
+  drawContext->flush();
   drawContext->glContext->bindDefaultFramebuffer();  
   drawContext->glContext->camera(uicam);
   // draw texture as rect onto screen at global origin pos
   Color drawColor(1.0f, 1.0f, 1.0f, layer->opacity());
   drawContext->drawTexturedRect(Rect(globalLayerOrigin, layer->rect().size()), drawBuffer, drawColor);
+  drawContext->flush(); // drawBuffer is reused for the next layer
 }
 
 #pragma mark - cached draw -
@@ -138,12 +151,23 @@ void Compositor::cachedDraw(const LayerPtr& rootLayer)
 {
   numDraws = 0;
   prepareRedraws(rootLayer);
-  updateLayerCaches();
+  updateLayerCaches(rootLayer.get()); // does nothing if no layer changed
 
+  // the root layer is composited straight into the default framebuffer instead of its own cache,
+  // so unchanged frames only draw the cached textures of its sublayers
+  drawContext->flush();
   drawContext->glContext->bindDefaultFramebuffer();
   drawContext->glContext->camera(uicam);
-  Color drawColor(1.0f, 1.0f, 1.0f, rootLayer->opacity());
-  drawContext->drawTexturedRect(rootLayer->rect(), layerCache[rootLayer.get()], drawColor);
+  drawContext->glContext->pushClippedScissorRect(rootLayer->rect());
+  auto pos = contentCache.find(rootLayer.get());
+  if(pos != contentCache.end())
+  {
+    Color drawColor(1.0f, 1.0f, 1.0f, rootLayer->opacity());
+    drawContext->drawTexturedRect(rootLayer->rect(), pos->second, drawColor);
+  }
+  drawSublayers(rootLayer.get(), rootLayer->pos(), rootLayer->opacity());
+  drawContext->flush();
+  drawContext->glContext->popScissorRect();
 //  DOUT("layer caches drawn: "<<numDraws);
 }
 
@@ -155,7 +179,7 @@ void Compositor::prepareRedraws(const LayerPtr rootLayer)
 //    DOUT("redraw candidates: "<<u64(redrawCandidates.size()));
     for(auto layer : redrawCandidates)
     {
-      if(layer->isVisibleWithinSuperlayers() && layer->isSublayerOf(rootLayer.get()))
+      if(layer->isVisibleWithinSuperlayers() && (layer->rootLayer() == rootLayer.get()))
       {
         redraws.push_back(layer);
       }
@@ -166,44 +190,98 @@ void Compositor::prepareRedraws(const LayerPtr rootLayer)
   }  
 }
 
-void Compositor::updateLayerCaches()
+void Compositor::updateLayerCaches(Layer* rootLayer)
 {
+  RenderTargetPool* pool = drawContext->glContext->renderTargetPool.get();
   for(Layer* layer : redraws)
   {
     numDraws++;
+    drawContext->flush(); // pending quads of the previous layer might reference the texture that is resized below
 //    DOUT(layer->z() << " : " << layer->description());
-    // find existing texture for layer or create new one and resize to current layer size
-    TexturePtr texture;
-    auto pos = layerCache.find(layer);
-    if(pos != layerCache.end())
+    Vec2 size = layer->rect().size();
+    fbcam->viewport(Rect(0,0,size));
+    
+    if(layer == rootLayer)
     {
-      texture = pos->second;
-      texture->init(layer->rect().size());
+      // composited by cachedDraw, only its own drawing is cached
+      updateContentCache(layer);
+      continue;
     }
-    else
+    
+    // keep the layers texture as long as its size fits, otherwise trade it for one from the pool
+    TexturePtr& texture = layerCache[layer];
+    texture = pool->resize(texture, size);
+    
+    if(layer->sublayers.empty())
     {
-      texture.reset(new Texture(layer->rect().size()));
-      layerCache[layer] = texture;
+      // without sublayers the own drawing is the whole layer, so it goes straight into the layer cache.
+      // a layer without sublayers is only scheduled if its drawing changed or it just lost its last sublayer
+      clearContentCache(layer);
+      pool->bind(texture);
+      drawContext->glContext->camera(fbcam);
+      layer->draw(drawContext);
+      continue;
     }
     
-    // set up frame buffer for layer cache
-    fb->bind();
-    fb->detachAll();
-    fb->attachColorBuffer(0, texture);
-    fb->check(); // FIXME: remove this once it is not needed anymore for debugging
-    fbcam->viewport(Rect(0,0,layer->rect().size()));
+    updateContentCache(layer);
+    
+    // set up frame buffer for layer cache, the texture is already attached to it
+    pool->bind(texture);
+    drawContext->glContext->camera(fbcam);
+    drawContext->glContext->clearColor(Color(0,0,0,0));
+    drawContext->glContext->clear(GL_COLOR_BUFFER_BIT);
+    auto pos = contentCache.find(layer);
+    if(pos != contentCache.end())
+    {
+      drawContext->drawTexturedRect(Rect(0,0,size), pos->second, whiteColor);
+    }
+    drawSublayers(layer, Vec2(0,0), 1.0f);
+  }
+}
+
+void Compositor::updateContentCache(Layer* layer)
+{
+  // transparent layers only composite their sublayers, so they don't need a texture for their own drawing
+  if(!layer->drawsContent())
+  {
+    clearContentCache(layer);
+    return;
+  }
+  
+  // draw current layer contents into its own cache, only if they changed. does NOT draw sublayers
+  RenderTargetPool* pool = drawContext->glContext->renderTargetPool.get();
+  TexturePtr& content = contentCache[layer];
+  TexturePtr previousContent = content;
+  content = pool->resize(content, layer->rect().size());
+  if((layer->contentGeneration == generation) || (content != previousContent))
+  {
+    pool->bind(content);
     drawContext->glContext->camera(fbcam);
-    // draw current layer contents. does NOT draw sublayers
     layer->draw(drawContext);
-    
-    // draw sublayer contents
-    for(LayerPtr sublayer : layer->sublayers)
+    drawContext->flush();
+  }
+}
+
+void Compositor::clearContentCache(Layer* layer)
+{
+  auto pos = contentCache.find(layer);
+  if(pos != contentCache.end())
+  {
+    drawContext->glContext->renderTargetPool->giveBack(pos->second);
+    contentCache.erase(pos);
+  }
+}
+
+void Compositor::drawSublayers(Layer* layer, const Vec2& origin, f32 opacity)
+{
+  for(LayerPtr sublayer : layer->sublayers)
+  {
+    // a sublayer has no cache if the compositor never drew it, skip it instead of drawing with a NULL texture
+    auto pos = layerCache.find(sublayer.get());
+    if(sublayer->visible() && (pos != layerCache.end()) && pos->second)
     {
-      if(sublayer->visible())
-      {
-        Color drawColor(1.0f,1.0f,1.0f, sublayer->opacity());
-        drawContext->drawTexturedRect(sublayer->rect(), layerCache[sublayer.get()], drawColor);
-      }
+      Color drawColor(1.0f,1.0f,1.0f, opacity*sublayer->opacity());
+      drawContext->drawTexturedRect(Rect(origin+sublayer->pos(), sublayer->size()), pos->second, drawColor);
     }
   }
 }
@@ -212,19 +290,19 @@ void Compositor::updateLayerCaches()
 
 void Compositor::needsRedraw(Layer* layer)
 {
-  while(layer)
-  {
-    checkedNeedsRedraw(layer);
-    layer = layer->superlayer;
-  }
+  layer->contentGeneration = generation;
+  needsComposition(layer);
 }
 
-void Compositor::checkedNeedsRedraw(Layer* layer)
+void Compositor::needsComposition(Layer* layer)
 {
-  auto pos = find(redrawCandidates.begin(), redrawCandidates.end(), layer);
-  if(pos == redrawCandidates.end())
+  // a layer that was already scheduled in this frame has all its superlayers scheduled too,
+  // so each layer is visited once per frame, no matter how many of its sublayers change
+  while(layer && (layer->redrawGeneration != generation))
   {
+    layer->redrawGeneration = generation;
     redrawCandidates.push_back(layer);
+    layer = layer->superlayer;
   }
 }
 
@@ -235,9 +313,14 @@ void Compositor::logCacheStats()
   {
     mem += (i.second->dataWidth * i.second->dataHeight);
   }
+  for(auto i : contentCache)
+  {
+    mem += (i.second->dataWidth * i.second->dataHeight);
+  }
   mem *= 4;
   mem /= 1024;
-  DOUT("Layer cache: entries"<<(u32)layerCache.size()<<" approx. mem: "<<mem<<" kb");
+  DOUT("Layer cache: entries"<<(u32)layerCache.size()<<" content entries: "<<(u32)contentCache.size()<<" approx. mem: "<<mem<<" kb");
+  drawContext->glContext->renderTargetPool->logStats();
 }
 
 }
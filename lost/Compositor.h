@@ -16,7 +16,8 @@ struct Compositor
   
   void windowResized(const Vec2& newSize);
   
-  void needsRedraw(Layer* layer);
+  void needsRedraw(Layer* layer); // the layers own drawing changed, redraws it and recomposites it and all its superlayers
+  void needsComposition(Layer* layer); // only the sublayers of layer moved, faded or changed, recomposites it and all its superlayers
   
   void layerDying(Layer* layer);
   void clearCacheForLayer(Layer* layer);
@@ -31,19 +32,22 @@ private:
   Vec2 windowSize;
   Camera2DPtr uicam;
   
-  FrameBufferPtr fb;
   Camera2DPtr fbcam;
   
   
   DrawContext* drawContext;
   
-  void checkedNeedsRedraw(Layer* layer);
   void prepareRedraws(const LayerPtr rootLayer);
-  void updateLayerCaches();
+  void updateLayerCaches(Layer* rootLayer);
+  void updateContentCache(Layer* layer);
+  void clearContentCache(Layer* layer);
+  void drawSublayers(Layer* layer, const Vec2& origin, f32 opacity); // draws the caches of all visible sublayers, offset by origin
   
+  u32 generation; // current frame, layers scheduled for redraw in it have the same redrawGeneration
   vector<Layer*> redrawCandidates;
   vector<Layer*> redraws;
-  map<Layer*, TexturePtr> layerCache;
+  map<Layer*, TexturePtr> layerCache; // composited layer including its sublayers, except for the root layer which is composited onto the screen
+  map<Layer*, TexturePtr> contentCache; // own drawing of layers with sublayers and of the root layer, layers without sublayers draw straight into layerCache
   
   // uncached drawing
   TexturePtr drawBuffer;
@@ -26,6 +26,9 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lost/Buffer.h"
 #include "lost/Application.h"
 #include "lost/FrameBuffer.h"
+#include "lost/RenderQueue.h"
+#include "lost/RenderTargetPool.h"
+#include "lost/VertexArray.h"
 #include <algorithm>
 
 namespace lost
@@ -90,6 +93,10 @@ if(member != newstate) \
     glDisable(pname);GLDEBUG; \
   } \
   member = newstate; \
+} \
+else \
+{ \
+  frameStats.redundantCallsAvoided++; \
 }
 
     Context::Context()
@@ -122,10 +129,27 @@ if(member != newstate) \
       clearVertexAttributeRequired();
       
       modelViewStack.push_back(Matrix::identity());
+      
+      _renderQueue = new RenderQueue;
+      renderTargetPool.reset(new RenderTargetPool);
+      _currentVertexArray = 0;
+      _currentAttributes = NULL;
+      
+      // Bitmap rows are tightly packed, which the default alignment of 4 only covers for RGBA
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);GLDEBUG;
     }
     
     Context::~Context()
     {
+      _quadIndices.reset();
+      renderTargetPool->purge();
+      renderTargetPool.reset();
+      delete _renderQueue;
+      unbindVertexArray();
+      for(auto i : _vertexArrays)
+      {
+        delete i.second;
+      }
     }
 
     Context* Context::instance()
@@ -135,6 +159,39 @@ if(member != newstate) \
       return Application::instance()->glContext;
     }
 
+    HybridIndexBufferPtr Context::quadIndices(u32 numQuads)
+    {
+      ASSERT(numQuads <= maxSharedQuads, "can't share indices for "<<numQuads<<" quads, max is "<<maxSharedQuads);
+      if(!_quadIndices)
+      {
+        _quadIndices.reset(new HybridIndexBuffer(ET_u16));
+        _quadIndices->drawMode = GL_TRIANGLES;
+      }
+      
+      // grow in powers of two and only write the new quads, the existing ones never change
+      u32 oldQuads = _quadIndices->hostBuffer->count / 6;
+      if(numQuads > oldQuads)
+      {
+        u32 newQuads = std::max(oldQuads, 64u);
+        while(newQuads < numQuads) { newQuads *= 2; }
+        newQuads = std::min(newQuads, maxSharedQuads);
+        _quadIndices->reserve(newQuads*6);
+        _quadIndices->hostBuffer->reset(newQuads*6);
+        for(u32 i=oldQuads; i<newQuads; ++i)
+        {
+          u32 idx = i*6;
+          u16 v = i*4;
+          _quadIndices->set(idx+0, UT_index, (u16)(v+0));
+          _quadIndices->set(idx+1, UT_index, (u16)(v+1));
+          _quadIndices->set(idx+2, UT_index, (u16)(v+2));
+          _quadIndices->set(idx+3, UT_index, (u16)(v+2));
+          _quadIndices->set(idx+4, UT_index, (u16)(v+3));
+          _quadIndices->set(idx+5, UT_index, (u16)(v+0));
+        }
+      }
+      return _quadIndices;
+    }
+
     void Context::bindDefaultFramebuffer()
     {
       bindFrameBuffer(_defaultFrameBuffer);
@@ -166,6 +223,7 @@ if(member != newstate) \
     {
       glBindFramebuffer(GL_FRAMEBUFFER, fb); GLASSERT;
       _currentFrameBuffer = fb;
+      frameStats.frameBufferSwitches++;
     }
 
 
@@ -180,6 +238,10 @@ if(member != newstate) \
         glCullFace(mode);GLDEBUG;
         cullFaceMode = mode;
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
     
     void Context::blendFunc(GLenum src, GLenum dest)
@@ -193,6 +255,10 @@ if(member != newstate) \
         currentBlendFuncSource = src;
         currentBlendFuncDestination = dest;
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
     
     void Context::scissor(bool enable) {SERVERSTATE(scissorEnabled, enable, GL_SCISSOR_TEST);}
@@ -204,6 +270,10 @@ if(member != newstate) \
         glScissor((GLint)rect.x, (GLint)rect.y, (GLsizei)rect.width, (GLsizei)rect.height);
         currentScissorRect = rect;
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
 
     void Context::pushScissorRect(const Rect& v)
@@ -247,6 +317,10 @@ if(member != newstate) \
         glClearColor(col.r(), col.g(), col.b(), col.a()); GLDEBUG;
         currentClearColor = col;
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
 
     void Context::viewport(const Rect& val)
@@ -256,6 +330,10 @@ if(member != newstate) \
         glViewport((GLint)val.x, (GLint)val.y, (GLsizei)val.width, (GLsizei)val.height);GLDEBUG;
         currentViewport = val;
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
 
     // only update if the new cam is either a new one or the same one, but with the dirty flag set. 
@@ -279,6 +357,10 @@ if(member != newstate) \
         glActiveTexture(tex);GLDEBUG;
         currentActiveTexture = tex;
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
     
     void Context::bindTexture(GLuint tex)
@@ -289,6 +371,11 @@ if(member != newstate) \
       {
         glBindTexture(GL_TEXTURE_2D, tex);GLASSERT;
         activeTextures[idx] = tex;
+        frameStats.textureBinds++;
+      }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
       }
     }
 
@@ -327,8 +414,13 @@ if(member != newstate) \
         if(currentShader)
         {
           glUseProgram(currentShader->program);GLASSERT;
+          frameStats.shaderSwitches++;
         }
       }
+      else
+      {
+        frameStats.redundantCallsAvoided++;
+      }
     }
 
     void Context::disableShader()
@@ -431,16 +523,17 @@ if(member != newstate) \
         
     void Context::draw(const MeshPtr& mesh)
     {
-      clearVertexAttributeRequired();
+      draw(mesh, mesh->transform * modelViewStack.back());
+    }
+
+    void Context::draw(const MeshPtr& mesh, const Matrix& modelView)
+    {
       HybridIndexBuffer* ib = mesh->indexBuffer.get();
       HybridVertexBuffer* vb = mesh->vertexBuffer.get();
 
       if(ib->dirty) {ib->upload();}
       if(vb->dirty) {vb->upload();}
 
-      bind(vb->gpuBuffer.get());
-      bind(ib->gpuBuffer.get());
-      
       if(mesh->material)
       {
         material(mesh->material);      
@@ -449,41 +542,201 @@ if(member != newstate) \
       // don't do anything if there's no shader
       if(currentShader)
       {      
+        UniformStats uniformStats = currentShader->uniformStats;
+        
         // set automatic uniforms if the shader wants them
-        if(currentShader->hasUniform("projectionMatrix")) { currentShader->set("projectionMatrix", currentCam->projectionMatrix() * currentCam->viewMatrix()); }
-        if(currentShader->hasUniform("modelViewMatrix")) { currentShader->set("modelViewMatrix", mesh->transform * modelViewStack.back()); }
-        if(currentShader->hasUniform("viewport")) { Rect v = currentCam->viewport(); currentShader->set("viewport", Vec2(v.width, v.height)); }
-        if(currentShader->hasUniform("depth")) { currentShader->set("depth", currentCam->depth()); }
-        if(currentShader->hasUniform("color")) { currentShader->set("color", mesh->material->color); }
-        if(currentShader->hasUniform("texture0")) { currentShader->setInt("texture0", 0); }
-        if(currentShader->hasUniform("texture1")) { currentShader->setInt("texture1", 1); }
-        if(currentShader->hasUniform("texture2")) { currentShader->setInt("texture2", 2); }
+        Uniform** builtins = currentShader->builtinUniforms;
+        if(builtins[BuiltinUniformProjectionMatrix]) { builtins[BuiltinUniformProjectionMatrix]->set(currentCam->projectionMatrix() * currentCam->viewMatrix()); }
+        if(builtins[BuiltinUniformModelViewMatrix]) { builtins[BuiltinUniformModelViewMatrix]->set(modelView); }
+        if(builtins[BuiltinUniformViewport]) { Rect v = currentCam->viewport(); builtins[BuiltinUniformViewport]->set(Vec2(v.width, v.height)); }
+        if(builtins[BuiltinUniformDepth]) { builtins[BuiltinUniformDepth]->set(currentCam->depth()); }
+        if(builtins[BuiltinUniformColor]) { builtins[BuiltinUniformColor]->set(mesh->material->color); }
+        if(builtins[BuiltinUniformTexture0]) { builtins[BuiltinUniformTexture0]->setInt(0); }
+        if(builtins[BuiltinUniformTexture1]) { builtins[BuiltinUniformTexture1]->setInt(1); }
+        if(builtins[BuiltinUniformTexture2]) { builtins[BuiltinUniformTexture2]->setInt(2); }
         
         // set mesh specific uniforms after automatic ones
         if(mesh->material->uniforms)
         {
           applyUniforms(mesh->material->uniforms.get());
         }
+        frameStats.uniformUploads += currentShader->uniformStats.issued - uniformStats.issued;
+        frameStats.redundantCallsAvoided += currentShader->uniformStats.skipped - uniformStats.skipped;
+
+        // map vertex attributes from buffer to shader, resolved once per shader and buffer combination
+        bindVertexArray(vertexArray(currentShader, vb, ib), vb, ib);
+      }
+      else
+      {
+        unbindVertexArray();
+        bind(vb->gpuBuffer.get());
+        bind(ib->gpuBuffer.get());
+        clearVertexAttributeRequired();
+        disableUnrequiredVertexAttributes();
+        _currentAttributes = NULL;
+      }
+      
+      u32 count = mesh->numIndices();
+      glDrawElements(ib->drawMode, count, ib->type, 0);GLDEBUG;
+      frameStats.drawCalls++;
+      switch(ib->drawMode)
+      {
+        case GL_TRIANGLES:frameStats.triangles += count/3;break;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:frameStats.triangles += (count > 2) ? count-2 : 0;break;
+        default:break;
+      }
+    }
 
-        // map vertex attributes from buffer to shader according to the vertex buffers attribute map
-        HybridBuffer::VertexAttributeMap::iterator i = vb->vertexAttributeMap.begin();
-        HybridBuffer::VertexAttributeMap::iterator end = vb->vertexAttributeMap.end();
-        for(i = vb->vertexAttributeMap.begin(); i!= end; ++i)
+#pragma mark - Vertex Arrays -
+
+    VertexArray* Context::vertexArray(ShaderProgram* prog, HybridVertexBuffer* vb, HybridIndexBuffer* ib)
+    {
+      VertexArrayKey key(prog, (u64(vb->gpuBuffer->buffer) << 32) | ib->gpuBuffer->buffer);
+      auto pos = _vertexArrays.find(key);
+      if(pos != _vertexArrays.end())
+      {
+        return pos->second;
+      }
+
+      // map vertex attributes from buffer to shader according to the vertex buffers attribute map
+      VertexArray* result = new VertexArray;
+      for(auto i : vb->vertexAttributeMap)
+      {
+        UsageType ut = i.first;
+        const string& attributeName = i.second;
+        if(vb->hasUsageType(ut) && prog->hasAttribute(attributeName))
         {
-          const string& attributeName = i->second;
-          UsageType ut = i->first;
-          if(currentShader->hasAttribute(attributeName))
+          VertexArray::Attribute attribute;
+          attribute.location = prog->name2vertexAttribute[attributeName].location;
+          attribute.apc = vb->pointerConfigForUsageType(ut);
+          result->attributes.push_back(attribute);
+        }
+      }
+      
+      if(hasVertexArrayObjects())
+      {
+        // record buffers and attribute pointers in the vao. The element array binding is part of the vao state,
+        // so it is bound directly, target2buffer only tracks the default vertex array.
+        genVertexArrays(1, &result->vao);
+        lost::bindVertexArray(result->vao);
+        _currentVertexArray = result->vao;
+        bind(vb->gpuBuffer.get());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gpuBuffer->buffer);GLASSERT;
+        for(const VertexArray::Attribute& attribute : result->attributes)
+        {
+          const AttributePointerConfig& apc = attribute.apc;
+          glEnableVertexAttribArray(attribute.location);GLDEBUG;
+          glVertexAttribPointer(attribute.location, apc.size, apc.type, apc.normalise, apc.stride, apc.offset);GLDEBUG;
+        }
+      }
+      
+      _vertexArrays[key] = result;
+      return result;
+    }
+
+    void Context::bindVertexArray(VertexArray* va, HybridVertexBuffer* vb, HybridIndexBuffer* ib)
+    {
+      if(va->vao)
+      {
+        if(_currentVertexArray != va->vao)
+        {
+          lost::bindVertexArray(va->vao);
+          _currentVertexArray = va->vao;
+          frameStats.bufferBinds++;
+        }
+        else
+        {
+          frameStats.redundantCallsAvoided++;
+        }
+      }
+      else
+      {
+        unbindVertexArray();
+        bind(vb->gpuBuffer.get());
+        bind(ib->gpuBuffer.get());
+        // attribute pointers are still valid if the last draw used the same binding
+        if(_currentAttributes != va)
+        {
+          clearVertexAttributeRequired();
+          for(const VertexArray::Attribute& attribute : va->attributes)
           {
-            const VertexAttribute& va = currentShader->name2vertexAttribute[attributeName];
-            const AttributePointerConfig apc = vb->pointerConfigForUsageType(ut);
-            vertexAttributeEnable(va.location, true);
-            glVertexAttribPointer(va.location, apc.size, apc.type, apc.normalise, apc.stride, apc.offset);GLDEBUG;
+            const AttributePointerConfig& apc = attribute.apc;
+            vertexAttributeEnable(attribute.location, true);
+            glVertexAttribPointer(attribute.location, apc.size, apc.type, apc.normalise, apc.stride, apc.offset);GLDEBUG;
           }
+          disableUnrequiredVertexAttributes();
+          _currentAttributes = va;
         }
       }
+    }
+
+    void Context::unbindVertexArray()
+    {
+      if(_currentVertexArray)
+      {
+        lost::bindVertexArray(0);
+        _currentVertexArray = 0;
+      }
+    }
+
+    void Context::deleteVertexArray(map<VertexArrayKey, VertexArray*>::iterator pos)
+    {
+      VertexArray* va = pos->second;
+      if(va->vao && (va->vao == _currentVertexArray))
+      {
+        unbindVertexArray();
+      }
+      if(va == _currentAttributes)
+      {
+        _currentAttributes = NULL;
+      }
+      delete va;
+      _vertexArrays.erase(pos);
+    }
+
+#pragma mark - Render Queue -
+
+    void Context::enqueue(const MeshPtr& mesh, u16 depth)
+    {
+      if(!_renderQueue->canAdd(_currentFrameBuffer))
+      {
+        flush();
+      }
+      _renderQueue->add(mesh, depth, _currentFrameBuffer, currentCam, mesh->transform * modelViewStack.back());
+    }
+
+    void Context::flush()
+    {
+      if(_renderQueue->empty()) return;
+      
+      GLuint previousFrameBuffer = _currentFrameBuffer;
+      CameraPtr previousCam = currentCam;
       
-      disableUnrequiredVertexAttributes();
-      glDrawElements(ib->drawMode, ib->hostBuffer->count, ib->type, 0);GLDEBUG;
+      _renderQueue->sort();
+      for(const RenderQueue::SortEntry& entry : _renderQueue->order)
+      {
+        RenderCommand& cmd = _renderQueue->commands[entry.second];
+        if(cmd.target != _currentFrameBuffer)
+        {
+          bindFrameBuffer(cmd.target);
+        }
+        if(cmd.cam)
+        {
+          camera(cmd.cam);
+        }
+        draw(cmd.mesh, cmd.modelView);
+      }
+      _renderQueue->clear();
+      
+      if(previousFrameBuffer != _currentFrameBuffer)
+      {
+        bindFrameBuffer(previousFrameBuffer);
+      }
+      if(previousCam)
+      {
+        camera(previousCam);
+      }
     }
 
     /** Uses glReadPixels to retrieve the current framebuffer data as rgba and saves it
@@ -513,14 +766,20 @@ if(member != newstate) \
 
     void Context::bind(Buffer* buffer)
     {
+      if(buffer->target == GL_ELEMENT_ARRAY_BUFFER)
+      {
+        unbindVertexArray(); // don't modify the element array binding of a vertex array object
+      }
       auto pos = target2buffer.find(buffer->target);
       if(pos == target2buffer.end() || (pos->second != buffer->buffer))
       {
         glBindBuffer(buffer->target, buffer->buffer);GLASSERT;
         target2buffer[buffer->target] = buffer->buffer;
+        frameStats.bufferBinds++;
       }
       else
       {
+        frameStats.redundantCallsAvoided++;
       }
     }
   
@@ -538,6 +797,35 @@ if(member != newstate) \
       }
     }
 
+#pragma mark - Frame Stats -
+
+void Context::FrameStats::reset()
+{
+  drawCalls = 0;
+  triangles = 0;
+  shaderSwitches = 0;
+  textureBinds = 0;
+  bufferBinds = 0;
+  uniformUploads = 0;
+  frameBufferSwitches = 0;
+  redundantCallsAvoided = 0;
+}
+
+void Context::beginFrame()
+{
+  lastFrameStats = frameStats;
+  frameStats.reset();
+}
+
+void Context::logFrameStats()
+{
+  DOUT("--- Frame Stats:");
+  DOUT("draw calls: "<<lastFrameStats.drawCalls<<" triangles: "<<lastFrameStats.triangles);
+  DOUT("shader switches: "<<lastFrameStats.shaderSwitches<<" texture binds: "<<lastFrameStats.textureBinds<<" buffer binds: "<<lastFrameStats.bufferBinds);
+  DOUT("uniform uploads: "<<lastFrameStats.uniformUploads<<" framebuffer switches: "<<lastFrameStats.frameBufferSwitches);
+  DOUT("redundant calls avoided: "<<lastFrameStats.redundantCallsAvoided);
+}
+
 #pragma mark - Resource Lifecycle & Cache Sync -
 
 void Context::logTextureStats()
@@ -596,7 +884,7 @@ void Context::textureDying(Texture* tex)
 void Context::bufferDying(Buffer* buffer)
 {
 //  DOUT("");
-  for(auto i : target2buffer)
+  for(auto& i : target2buffer)
   {
     if(i.second == buffer->buffer)
     {
@@ -604,11 +892,31 @@ void Context::bufferDying(Buffer* buffer)
       DOUT("removing dying Buffer "<<buffer->buffer);
     }
   }
+  
+  // vertex arrays referencing the buffer, the name might be reused for a new buffer
+  for(auto pos = _vertexArrays.begin(); pos != _vertexArrays.end();)
+  {
+    auto current = pos++;
+    u64 buffers = current->first.second;
+    if(((buffers >> 32) == buffer->buffer) || ((buffers & 0xffffffff) == buffer->buffer))
+    {
+      deleteVertexArray(current);
+    }
+  }
 }
 
 void Context::shaderprogramDying(ShaderProgram* prog)
 {
   DOUT("");
+  for(auto pos = _vertexArrays.begin(); pos != _vertexArrays.end();)
+  {
+    auto current = pos++;
+    if(current->first.first == prog)
+    {
+      deleteVertexArray(current);
+    }
+  }
+
   if(currentShader == prog)
   {
     disableShader();
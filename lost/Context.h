@@ -32,6 +32,10 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace lost
 {
+
+struct RenderQueue;
+struct VertexArray;
+
 struct Context
 {
 // private for now, deliberately no getters
@@ -69,12 +73,50 @@ private:
   
   vector<Texture*> _textures;
   
+  RenderQueue*    _renderQueue;
+  
+  typedef pair<ShaderProgram*, u64> VertexArrayKey; // shader, vertex buffer name << 32 | index buffer name
+  map<VertexArrayKey, VertexArray*> _vertexArrays;
+  GLuint          _currentVertexArray; // bound vertex array object, 0 is the default one
+  VertexArray*    _currentAttributes; // emulated vertex array whose attributes are currently set up, NULL if unknown
+  
+  VertexArray* vertexArray(ShaderProgram* prog, HybridVertexBuffer* vb, HybridIndexBuffer* ib); // finds or creates the binding
+  void bindVertexArray(VertexArray* va, HybridVertexBuffer* vb, HybridIndexBuffer* ib);
+  void unbindVertexArray(); // switches back to the default vertex array object if another one is bound
+  void deleteVertexArray(map<VertexArrayKey, VertexArray*>::iterator pos);
+  
+  HybridIndexBufferPtr _quadIndices; // shared by all quad based meshes, see quadIndices()
+  
 public:
+  // counts GL work and avoided redundant state changes, see beginFrame()
+  struct FrameStats
+  {
+    FrameStats() { reset(); }
+    void reset();
+    
+    u32 drawCalls;
+    u32 triangles;
+    u32 shaderSwitches;
+    u32 textureBinds;
+    u32 bufferBinds;
+    u32 uniformUploads; // uploads issued while setting up draws, unchanged values are counted as redundant
+    u32 frameBufferSwitches;
+    u32 redundantCallsAvoided; // state changes that were filtered because the value was already set
+  };
+  
+  FrameStats      frameStats; // counters of the frame in progress
+  FrameStats      lastFrameStats; // counters of the last completed frame, use this one for display
+  
   Context();
   ~Context();
 
   static Context* instance(); // returns the context instance created by the application. 
 
+  static const u32 maxSharedQuads = 16384; // 4 vertices per quad, so the shared quad indices still fit into u16
+  HybridIndexBufferPtr quadIndices(u32 numQuads); // returns the shared u16 index buffer with the 0,1,2,2,3,0 pattern, grown to hold at least numQuads quads
+
+  RenderTargetPoolPtr renderTargetPool; // textures for layer caches and canvases, shared with canvases since they can outlive the Context
+
   void bindDefaultFramebuffer();
   void defaultFramebuffer(GLuint fbo);
   GLuint defaultFramebuffer();
@@ -113,6 +155,9 @@ public:
   void disableShader(); // sets the currently active shader program to zero
   
   void draw(const MeshPtr& mesh);
+  void draw(const MeshPtr& mesh, const Matrix& modelView); // draws mesh with the given modelview matrix, ignoring mesh->transform and the modelview stack
+  void enqueue(const MeshPtr& mesh, u16 depth=0); // records a draw call for the current framebuffer and camera instead of drawing immediately. See RenderQueue.h for the meaning of depth.
+  void flush(); // sorts and draws all enqueued meshes, restores framebuffer and camera afterwards
   void writeScreenshot(const string& fullPathName, bool withAlphaChannel); // writes the current framebuffer with the current viewport configurtaion to a file as a tga, with optional alpha channel.
     
   void bind(Buffer* buffer);
@@ -122,6 +167,9 @@ public:
   void clearVertexAttributeRequired();
   void disableUnrequiredVertexAttributes();
   
+  void beginFrame(); // called by Application at the start of each frame, moves frameStats to lastFrameStats and resets frameStats
+  void logFrameStats(); // logs lastFrameStats
+  
   // resource lifecycle & cache sync
   void logTextureStats();
   void textureCreated(Texture* tex);
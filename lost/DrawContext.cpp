@@ -6,9 +6,13 @@
 #include "lost/ResourceManager.h"
 #include "lost/TextRender.h"
 #include "lost/TextMesh.h"
+#include "lost/TextMeshCache.h"
+#include "lost/Font.h"
 #include "lost/Bitmap.h"
 #include "lost/NinePatch.h"
 #include "lost/TextBuffer.h"
+#include "lost/QuadBatch.h"
+#include "lost/UniformBlock.h"
 
 namespace lost
 {
@@ -20,47 +24,19 @@ DrawContext::DrawContext(Context* ctx)
   glContext = ctx;
   
   _textBuffer = new TextBuffer;
+  _sdfTextShaderHasDerivatives = false;
   
   // load some common shaders
   colorShader = Application::instance()->resourceManager->shader("resources/glsl/color");
   textureShader = Application::instance()->resourceManager->shader("resources/glsl/texture");
+  textShader = Application::instance()->resourceManager->shader("resources/glsl/text");
   
-  // create buffers for efficient quad drawing. Vertex and index buffers are reused as often as possible
-  BufferLayout layout;
-  layout.add(ET_vec2_f32, UT_position);
-  layout.add(ET_vec2_f32, UT_texcoord0);
-  bgquad = Mesh::create(layout, ET_u16);
-  bgquad->resetSize(4, 6);
-  bgquad->indexBuffer->drawMode = GL_TRIANGLES;
+  // rects and images are collected in a batch and drawn together
+  batchColorShader = Application::instance()->resourceManager->shader("resources/glsl/batchcolor");
+  batchTextureShader = Application::instance()->resourceManager->shader("resources/glsl/batchtexture");
+  _quadBatch = new QuadBatch(ctx);
   
-  bgquad->set(0, UT_position, Vec2(0,0));
-  bgquad->set(1, UT_position, Vec2(1,0));
-  bgquad->set(2, UT_position, Vec2(1,1));
-  bgquad->set(3, UT_position, Vec2(0,1));
-  
-  bgquad->set(0,UT_texcoord0, Vec2(0,0));
-  bgquad->set(1,UT_texcoord0, Vec2(1,0));
-  bgquad->set(2,UT_texcoord0, Vec2(1,1));
-  bgquad->set(3,UT_texcoord0, Vec2(0,1));
-  
-  bgquad->set(0, UT_index, (u16)0);
-  bgquad->set(1, UT_index, (u16)1);
-  bgquad->set(2, UT_index, (u16)2);
-  bgquad->set(3, UT_index, (u16)2);
-  bgquad->set(4, UT_index, (u16)3);
-  bgquad->set(5, UT_index, (u16)0);
-  
-  bgquad->material->shader = colorShader;
-  bgquad->material->color = whiteColor;
-  bgquad->material->blendPremultiplied();
-  
-  textMesh.reset(new TextMesh);
-  textMesh->material->shader = textureShader;
-  textMesh->material->color = whiteColor;
-  
-  _flipX = false;
-  _flipY = false;
-  updateTexCoords();
+  textMeshCache = new TextMeshCache;
   
   ninePatch.reset(new NinePatch);
   ninePatch->flip = true;
@@ -129,91 +105,91 @@ TexturePtr DrawContext::ring(u16 radius, u16 thickness)
 
 #pragma mark - tex coord updates for image flipping - 
 
-void DrawContext::updateTexCoords()
+// texcoords for the bottom left, bottom right, top right and top left corners of a quad
+struct QuadTexCoords
 {
-  if(!_flipX && !_flipY)
-  {
-    bgquad->set(0,UT_texcoord0, Vec2(0,0));
-    bgquad->set(1,UT_texcoord0, Vec2(1,0));
-    bgquad->set(2,UT_texcoord0, Vec2(1,1));
-    bgquad->set(3,UT_texcoord0, Vec2(0,1));
-  }
-  else if(_flipX && !_flipY)
+  Vec2 bl, br, tr, tl;
+  
+  QuadTexCoords(const Vec2& inBl, const Vec2& inBr, const Vec2& inTr, const Vec2& inTl) : bl(inBl), br(inBr), tr(inTr), tl(inTl) {}
+};
+
+static QuadTexCoords texCoords(bool flipX, bool flipY)
+{
+  if(flipX && flipY)
   {
-    bgquad->set(0,UT_texcoord0, Vec2(1,0));
-    bgquad->set(1,UT_texcoord0, Vec2(0,0));
-    bgquad->set(2,UT_texcoord0, Vec2(0,1));
-    bgquad->set(3,UT_texcoord0, Vec2(1,1));
+    return QuadTexCoords(Vec2(1,1), Vec2(0,1), Vec2(0,0), Vec2(1,0));
   }
-  else if(!_flipX && _flipY)
+  else if(flipX)
   {
-    bgquad->set(0,UT_texcoord0, Vec2(0,1));
-    bgquad->set(1,UT_texcoord0, Vec2(1,1));
-    bgquad->set(2,UT_texcoord0, Vec2(1,0));
-    bgquad->set(3,UT_texcoord0, Vec2(0,0));
+    return QuadTexCoords(Vec2(1,0), Vec2(0,0), Vec2(0,1), Vec2(1,1));
   }
-  else if(_flipX && _flipY)
+  else if(flipY)
   {
-    bgquad->set(0,UT_texcoord0, Vec2(1,1));
-    bgquad->set(1,UT_texcoord0, Vec2(0,1));
-    bgquad->set(2,UT_texcoord0, Vec2(0,0));
-    bgquad->set(3,UT_texcoord0, Vec2(1,0));
+    return QuadTexCoords(Vec2(0,1), Vec2(1,1), Vec2(1,0), Vec2(0,0));
   }
+  return QuadTexCoords(Vec2(0,0), Vec2(1,0), Vec2(1,1), Vec2(0,1));
 }
 
-void DrawContext::updateTexCoords(bool flipX, bool flipY)
+static Vec2 scaled(const Vec2& v, const Vec2& s)
 {
-  // disabled flip state caching and comparison since it would clash with image drawing when
-  // state wasn't set 
-//  if((_flipX != flipX) || (_flipY != flipY))
-//  {
-    _flipX = flipX;
-    _flipY = flipY;
-    updateTexCoords();
-//  }
+  return Vec2(v.x*s.x, v.y*s.y);
 }
 
-void DrawContext::setTexCoords(const Vec2& bl,
-                  const Vec2& br,
-                  const Vec2& tr,
-                  const Vec2& tl)
+static QuadTexCoords texCoords(const ImagePtr& image)
 {
-  bgquad->set(0,UT_texcoord0, bl);
-  bgquad->set(1,UT_texcoord0, br);
-  bgquad->set(2,UT_texcoord0, tr);
-  bgquad->set(3,UT_texcoord0, tl);
+  switch(image->orientation)
+  {
+    case ImageOrientationDown:return QuadTexCoords(image->tr, image->tl, image->bl, image->br);
+    case ImageOrientationLeft:return QuadTexCoords(image->br, image->tr, image->tl, image->bl);
+    case ImageOrientationRight:return QuadTexCoords(image->tl, image->bl, image->br, image->tr);
+
+    case ImageOrientationUpMirrored:return QuadTexCoords(image->br, image->bl, image->tl, image->tr);
+    case ImageOrientationDownMirrored:return QuadTexCoords(image->tl, image->tr, image->br, image->bl);
+    case ImageOrientationLeftMirrored:return QuadTexCoords(image->tr, image->br, image->bl, image->tl);
+    case ImageOrientationRightMirrored:return QuadTexCoords(image->bl, image->tl, image->tr, image->br);
+    
+    case ImageOrientationUp:
+    default:return QuadTexCoords(image->bl, image->br, image->tr, image->tl);
+  }
 }
 
-
 #pragma mark - drawing -
 
+void DrawContext::flush()
+{
+  _quadBatch->flush();
+}
+
 void DrawContext::drawSolidRect(const Rect& rect, const Color& col)
 {
-  bgquad->transform = Matrix::translate(Vec3(rect.x, rect.y, 0)) * Matrix::scale(Vec3(rect.width, rect.height, 1));
-  bgquad->material->color = col.premultiplied();
-  bgquad->material->shader = colorShader;
-  bgquad->material->blendPremultiplied();
-  glContext->draw(bgquad);
+  _quadBatch->state(batchColorShader, TexturePtr(), GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  _quadBatch->add(rect, col.premultiplied());
 }
 
 void DrawContext::drawTexturedRect(const Rect& rect, const TexturePtr& tex, const Color& col, bool flipX, bool flipY)
 {
-  updateTexCoords(flipX, flipY);
-  bgquad->transform = Matrix::translate(rect.x, rect.y) * Matrix::scale(rect.width, rect.height);
-  bgquad->material->color = col.premultiplied();
-  bgquad->material->shader = textureShader;
-  bgquad->material->limitTextures(1);
-  bgquad->material->setTexture(0, tex);
-  bgquad->material->blendPremultiplied();
-  glContext->draw(bgquad);
+  QuadTexCoords tc = texCoords(flipX, flipY);
+  // only draw the data area of textures that are larger, like pooled render targets
+  Vec2 tr = tex ? tex->topRightTexCoord() : Vec2(1,1);
+  tc = QuadTexCoords(scaled(tc.bl, tr), scaled(tc.br, tr), scaled(tc.tr, tr), scaled(tc.tl, tr));
+  _quadBatch->state(batchTextureShader, tex, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  _quadBatch->add(rect, col.premultiplied(), tc.bl, tc.br, tc.tr, tc.tl);
 }
 
 void DrawContext::drawText(const string& text, const FontPtr& font, const Color& col, const Vec2& pos, int alignment)
 {
-  render(text, font, textMesh, true, alignment);
+  flush();
+  // single line text is cached with a negative width so it never matches wrapped text
+  TextMeshCache::Key key(text, font, -1, BREAKMODE_NONE, alignment);
+  TextMeshPtr textMesh = textMeshCache->mesh(key);
+  if(!textMesh)
+  {
+    textMesh = TextMesh::create();
+    render(text, font, textMesh, true, alignment);
+    textMeshCache->mesh(key, textMesh);
+  }
   textMesh->transform = Matrix::translate(Vec3(pos.x, pos.y, 0));
-  textMesh->material->color = col.premultiplied();
-  textMesh->material->blendPremultiplied();
+  applyTextMaterial(textMesh, font, col);
   glContext->draw(textMesh);
 }
 
@@ -225,14 +201,22 @@ void DrawContext::drawText( const string& text,
                             TextAlignment alignment,
                             BreakMode breakmode)
 {
-  _textBuffer->text(text);
-  _textBuffer->font(font);
-  _textBuffer->setAlign(alignment);
-  _textBuffer->setCharacterMetrics(false);
-  _textBuffer->breakMode(breakmode);
-  _textBuffer->width(targetRect.width);
-  _textBuffer->reset();
-  _textBuffer->renderAllPhysicalLines(textMesh);
+  flush();
+  TextMeshCache::Key key(text, font, targetRect.width, breakmode, alignment);
+  TextMeshPtr textMesh = textMeshCache->mesh(key);
+  if(!textMesh)
+  {
+    textMesh = TextMesh::create();
+    _textBuffer->text(text);
+    _textBuffer->font(font);
+    _textBuffer->setAlign(alignment);
+    _textBuffer->setCharacterMetrics(false);
+    _textBuffer->breakMode(breakmode);
+    _textBuffer->width(targetRect.width);
+    _textBuffer->reset();
+    _textBuffer->renderAllPhysicalLines(textMesh);
+    textMeshCache->mesh(key, textMesh);
+  }
 
 //  DOUT("textmesh size "<<textMesh->size<<" target rect: "<<targetRect);
 
@@ -249,11 +233,69 @@ void DrawContext::drawText( const string& text,
   }
 
   textMesh->transform = Matrix::translate(targetRect.x+dx, targetRect.y+dy);
-  textMesh->material->color = col.premultiplied();
-  textMesh->material->blendPremultiplied();
+  applyTextMaterial(textMesh, font, col);
   glContext->draw(textMesh);  
 }
 
+void DrawContext::drawText(TextBuffer* buffer, const Color& col, const Rect& targetRect, float scrollOffset)
+{
+  flush();
+  buffer->reset();
+  buffer->renderVisiblePhysicalLines(scrollOffset, targetRect.height, _visibleLines);
+  
+  // the first and last line are usually only partly visible
+  glContext->pushClippedScissorRect(targetRect);
+  Matrix origin = Matrix::translate(targetRect.x, targetRect.y);
+  for(vector<TextMeshPtr>::iterator pos=_visibleLines.begin(); pos!=_visibleLines.end(); ++pos)
+  {
+    const TextMeshPtr& mesh = *pos;
+    mesh->transform = origin * mesh->transform;
+    applyTextMaterial(mesh, buffer->font(), col);
+    glContext->draw(mesh);
+  }
+  glContext->popScissorRect();
+}
+
+const ShaderProgramPtr& DrawContext::textShaderFor(const FontPtr& font)
+{
+  if(!font->signedDistanceField)
+  {
+    return textShader;
+  }
+  
+  if(!_sdfTextShader)
+  {
+    // fwidth is core in desktop GL, but an optional extension on GLES2 that e.g. the Raspberry Pi doesn't have
+  #if TARGET_OPENGL_ES
+    _sdfTextShaderHasDerivatives = hasExtension("GL_OES_standard_derivatives");
+  #else
+    _sdfTextShaderHasDerivatives = true;
+  #endif
+    _sdfTextShader = Application::instance()->resourceManager->shader(_sdfTextShaderHasDerivatives ? "resources/glsl/sdftext" : "resources/glsl/sdftextfixed");
+  }
+  return _sdfTextShader;
+}
+
+void DrawContext::applyTextMaterial(const TextMeshPtr& mesh, const FontPtr& font, const Color& col)
+{
+  mesh->material->shader = textShaderFor(font);
+  mesh->material->color = col.premultiplied();
+  mesh->material->blendPremultiplied();
+  if(font->signedDistanceField && !_sdfTextShaderHasDerivatives)
+  {
+    // text is drawn unscaled, so half a pixel at the font size is what fwidth would have computed
+    if(!mesh->material->uniforms)
+    {
+      mesh->material->uniforms = UniformBlock::create();
+    }
+    mesh->material->uniforms->setFloat("smoothing", font->sdfSmoothing);
+  }
+  else
+  {
+    mesh->material->uniforms.reset(); // meshes are recycled between fonts
+  }
+}
+
 
 void DrawContext::drawRoundRect(const Rect& rect, u16 r, const Color& col)
 {
@@ -274,6 +316,7 @@ void DrawContext::drawRectFrame(const Rect& rect, u16 thickness, const Color& co
 
 void DrawContext::drawRR(const Rect& rect, u16 r, const TexturePtr& tex, const Color& col)
 {
+  flush();
   ninePatch->update(tex, rect.size(), r, r, r, r);
   ninePatch->material->color = col.premultiplied();
   ninePatch->transform = Matrix::translate(Vec3(rect.x, rect.y, 0));
@@ -297,18 +340,14 @@ void DrawContext::drawImage(const ImagePtr& image, const Rect& rect, const Color
 
 void DrawContext::drawImageStretched(const ImagePtr& image, const Rect& rect, const Color& col)
 {
-  updateQuadTexCoordsFromImage(image);
-  bgquad->transform = Matrix::translate(rect.x, rect.y) * Matrix::scale(Vec3(rect.width, rect.height, 1));
-  bgquad->material->color = col.premultiplied();
-  bgquad->material->shader = textureShader;
-  bgquad->material->limitTextures(1);
-  bgquad->material->setTexture(0, image->texture);
-  bgquad->material->blendPremultiplied();
-  glContext->draw(bgquad);  
+  QuadTexCoords tc = texCoords(image);
+  _quadBatch->state(batchTextureShader, image->texture, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  _quadBatch->add(rect, col.premultiplied(), tc.bl, tc.br, tc.tr, tc.tl);
 }
 
 void DrawContext::drawImageNinepatched(const ImagePtr& image, const Rect& rect, const Color& col)
 {
+  flush();
   ninePatch->update(image->texture, rect.size(), image->l, image->r, image->t, image->b);
   ninePatch->material->color = col.premultiplied();
   ninePatch->transform = Matrix::translate(Vec3(rect.x, rect.y, 0));
@@ -320,22 +359,6 @@ void DrawContext::drawImageTiled(const ImagePtr& image, const Rect& rect, const
   WOUT("not implemented yet");
 }
 
-void DrawContext::updateQuadTexCoordsFromImage(ImagePtr image)
-{
-  switch(image->orientation)
-  {
-    case ImageOrientationUp:setTexCoords(image->bl, image->br, image->tr, image->tl);break;
-    case ImageOrientationDown:setTexCoords(image->tr, image->tl, image->bl, image->br);break;
-    case ImageOrientationLeft:setTexCoords(image->br, image->tr, image->tl, image->bl);break;
-    case ImageOrientationRight:setTexCoords(image->tl, image->bl, image->br, image->tr);break;
-
-    case ImageOrientationUpMirrored:setTexCoords(image->br, image->bl, image->tl, image->tr);break;
-    case ImageOrientationDownMirrored:setTexCoords(image->tl, image->tr, image->br, image->bl);break;
-    case ImageOrientationLeftMirrored:setTexCoords(image->tr, image->br, image->bl, image->tl);break;
-    case ImageOrientationRightMirrored:setTexCoords(image->bl, image->tl, image->tr, image->br);break;
-  }
-}
-
 }
 
 
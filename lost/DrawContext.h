@@ -6,6 +6,8 @@ namespace lost
 
 struct Context;
 struct TextBuffer;
+struct QuadBatch;
+struct TextMeshCache;
 
 /** Bundles common functions and resources for efficient 2D UI drawing.
  * Layers don't need to use this, but having this helps share some resources.
@@ -14,8 +16,11 @@ struct DrawContext
 {
   DrawContext(Context* ctx);
   
+  // rects and stretched images are batched. Call flush before switching framebuffers or cameras, or drawing directly with the Context.
+  void flush();
+  
   void drawSolidRect(const Rect& rect, const Color& col);
-  void drawTexturedRect(const Rect& rect, const TexturePtr& tex, const Color& col, bool flipX=false, bool flipY=false);
+  void drawTexturedRect(const Rect& rect, const TexturePtr& tex, const Color& col, bool flipX=false, bool flipY=false); // draws the dataWidth x dataHeight area of tex
   void drawText(const string& text, const FontPtr& font, const Color& col, const Vec2& pos, int alignment);
 
   void drawText(const string& text,
@@ -26,6 +31,9 @@ struct DrawContext
                 TextAlignment alignment,
                 BreakMode breakmode);
   
+  // draws only the lines of buffer that are visible in targetRect when the text is scrolled down by scrollOffset pixels, clipped to targetRect
+  void drawText(TextBuffer* buffer, const Color& col, const Rect& targetRect, float scrollOffset);
+  
   void drawRoundRect(const Rect& rect, u16 radius, const Color& col);
   void drawRoundRectFrame(const Rect& rect, u16 radius, u16 thickness, const Color& col);
   void drawRectFrame(const Rect& rect, u16 thickness, const Color& col);
@@ -38,22 +46,27 @@ struct DrawContext
   TexturePtr disc(u16 radius);
   TexturePtr ring(u16 radius, u16 thickness);
   
+  // textShader, or for fonts with distance field glyphs resources/glsl/sdftext, which is only loaded once it's needed.
+  // Without GL_OES_standard_derivatives, resources/glsl/sdftextfixed is used instead, with a smoothing uniform that applyTextMaterial sets
+  const ShaderProgramPtr& textShaderFor(const FontPtr& font);
+  void applyTextMaterial(const TextMeshPtr& mesh, const FontPtr& font, const Color& col);
+  
   ShaderProgramPtr colorShader;
   ShaderProgramPtr textureShader;
+  ShaderProgramPtr textShader; // multiplies glyph coverage from the atlas with the material color
+  ShaderProgramPtr batchColorShader; // per vertex color, used for batched quads
+  ShaderProgramPtr batchTextureShader;
   
   Context* glContext;
-  MeshPtr bgquad;
-  TextMeshPtr textMesh;
+  TextMeshCache* textMeshCache; // laid out strings are drawn from here until they're evicted
   NinePatchPtr ninePatch;
   
 private:
   TextBuffer* _textBuffer;
-  bool _flipX;
-  bool _flipY;
-  void updateTexCoords(); // always updates texcoords for current flip settings
-  void setTexCoords(const Vec2& bl, const Vec2& br, const Vec2& tr, const Vec2& tl); // always updates texcoords for current flip settings
-  void updateTexCoords(bool flipX, bool flipY); // checks if new flags are different and triggers optional update
-  void updateQuadTexCoordsFromImage(ImagePtr image);
+  QuadBatch* _quadBatch;
+  ShaderProgramPtr _sdfTextShader;
+  bool _sdfTextShaderHasDerivatives;
+  vector<TextMeshPtr> _visibleLines;
   void drawRR(const Rect& rect, u16 r, const TexturePtr& tex, const Color& col);
   void drawImageStretched(const ImagePtr& image, const Rect& rect, const Color& col);
   void drawImageNinepatched(const ImagePtr& image, const Rect& rect, const Color& col);
@@ -21,17 +21,19 @@ namespace lost
 {
 struct Font
 {
-  Font() {};
+  Font() { signedDistanceField = false; sdfSmoothing = 0; };
   virtual ~Font() {};
   
   virtual bool      hasKerning() = 0;
   virtual GlyphPtr  glyph(uint32_t utf32character) = 0;
   virtual float     kerningOffset(uint32_t previousChar, uint32_t currentChar) = 0;
-  virtual float     characterAdvance(uint32_t previousChar, uint32_t currentChar) = 0; // returns advance (if glyph available)+kerningOffset (if kerning available), 0 otherwise. Use 0 if there is no prevchar
+  virtual float     characterAdvance(uint32_t previousChar, uint32_t currentChar) = 0; // returns advance (if glyph available)+kerningOffset (if kerning available), 0 otherwise. Use 0 if there is no prevchar. Must not rasterize the glyph, it's used to measure text
+  virtual void      moveToCurrentPage(uint32_t utf32character) = 0; // adds an existing glyph again to the current atlas page, so it can be drawn with glyphs that were added later
 
-  uint32_t    size;
-  TexturePtr  atlas;
-  Vec2        atlasSize;
+  uint32_t      size;
+  GlyphAtlasPtr atlas; // might be shared with other fonts
+  bool          signedDistanceField; // true if glyphs are distance fields that have to be drawn with resources/glsl/sdftext
+  float         sdfSmoothing; // half a screen pixel in distance field units when drawn at size, for shaders without fwidth
   float       lineHeight;
   float       ascender;
   float       descender;
@@ -249,7 +249,10 @@ namespace lost
   
     FrameBuffer::~FrameBuffer()
     {
-      Context::instance()->framebufferDying(this);
+      if(Context::instance()) // NULL after shutdown
+      {
+        Context::instance()->framebufferDying(this);
+      }
       glDeleteFramebuffers(1, &buffer); GLASSERT;
     }
 
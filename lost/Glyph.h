@@ -28,15 +28,16 @@ struct Glyph
     xoffset = 0;
     yoffset = 0;
     advance = 0;
+    page = 0;
   }
 
   Rect  rect; // the glyphs bitmaps rect inside the atlas texture
+  u32   page; // the GlyphAtlas page that contains the glyph
+  Vec2  size; // size of the quad in pixels. Same as the size of rect, unless the bitmap is scaled to the font size
   s32   xoffset;
   s32   yoffset;
   s32   advance;
   bool  drawable;
-  
-  BitmapPtr bitmap;
 };
 
 }
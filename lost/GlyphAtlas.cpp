@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "lost/GlyphAtlas.h"
+#include "lost/Glyph.h"
+#include "lost/Bitmap.h"
+#include "lost/Texture.h"
+
+namespace lost
+{
+
+GlyphAtlas::GlyphAtlas(const Vec2& inPageSize, GLenum inFormat, GLint inFilter)
+{
+  ASSERT((inFormat == GL_ALPHA) || (inFormat == GL_RGBA), "glyph atlas format must be GL_ALPHA or GL_RGBA");
+  pageSize = inPageSize;
+  format = inFormat;
+  filter = inFilter;
+  newPage();
+}
+
+void GlyphAtlas::newPage()
+{
+  BitmapPtr empty(new Bitmap((uint32_t)pageSize.width, (uint32_t)pageSize.height, format));
+  empty->clear(Color(0,0,0,0));
+  
+  Page page;
+  Texture::Params params;
+  params.minFilter = filter;
+  params.magFilter = filter;
+  page.texture.reset(new Texture(empty, params));
+  page.packer.reset(pageSize);
+  pages.push_back(page);
+//  DOUT("glyph atlas pages: "<<(u32)pages.size());
+}
+
+bool GlyphAtlas::add(const GlyphPtr& glyph, const BitmapPtr& bmp)
+{
+  Vec2 size((float)bmp->width, (float)bmp->height);
+  float padding = (float)pages.back().packer.padding;
+  if((size.width+padding > pageSize.width) || (size.height+padding > pageSize.height))
+  {
+    WOUT("glyph of size "<<size<<" doesn't fit into atlas pages of size "<<pageSize);
+    return false;
+  }
+  
+  if(!pages.back().packer.add(size, glyph->rect))
+  {
+    newPage();
+    pages.back().packer.add(size, glyph->rect);
+  }
+  glyph->page = currentPage();
+  
+  Texture* tex = pages.back().texture.get();
+  tex->bind();
+  tex->subImage(Vec2(glyph->rect.x, glyph->rect.y), bmp);
+  return true;
+}
+
+const GlyphAtlas::SharedGlyph* GlyphAtlas::sharedGlyph(const void* face, char32_t c)
+{
+  map<pair<const void*, char32_t>, SharedGlyph>::iterator pos = _sharedGlyphs.find(make_pair(face, c));
+  return (pos != _sharedGlyphs.end()) ? &(pos->second) : NULL;
+}
+
+void GlyphAtlas::shareGlyph(const void* face, char32_t c, const GlyphPtr& glyph)
+{
+  SharedGlyph& shared = _sharedGlyphs[make_pair(face, c)];
+  shared.page = glyph->page;
+  shared.rect = glyph->rect;
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef LOST_GLYPHATLAS_H
+#define LOST_GLYPHATLAS_H
+
+#include "lost/ShelfPacker.h"
+
+namespace lost
+{
+
+/** Texture pages that hold the glyph bitmaps of any number of fonts.
+ *  Glyphs are added to the current page, a new page is opened when it is full. Glyphs never move once they were added,
+ *  so text meshes stay valid. Fonts that share an atlas usually end up on the same page, so their text can be drawn 
+ *  with the same texture.
+ */
+struct GlyphAtlas
+{
+  struct Page
+  {
+    TexturePtr  texture;
+    ShelfPacker packer;
+  };
+  
+  // glyphs that look the same in all font sizes, like distance fields, are only added once per face
+  struct SharedGlyph
+  {
+    uint32_t  page;
+    Rect      rect;
+  };
+  
+  // distance field atlases need GL_LINEAR filtering
+  GlyphAtlas(const Vec2& inPageSize = Vec2(512, 512), GLenum inFormat = GL_ALPHA, GLint inFilter = GL_NEAREST);
+  static GlyphAtlasPtr create(const Vec2& inPageSize = Vec2(512, 512), GLenum inFormat = GL_ALPHA, GLint inFilter = GL_NEAREST) { return GlyphAtlasPtr(new GlyphAtlas(inPageSize, inFormat, inFilter)); }
+  
+  /** uploads the glyphs bitmap to the current page, opening a new page if it doesn't fit anymore.
+   *  The bitmap must have the format of the atlas. Sets the glyphs page and rect.
+   *  @return false if the bitmap is larger than a page.
+   */
+  bool add(const GlyphPtr& glyph, const BitmapPtr& bmp);
+  
+  const SharedGlyph* sharedGlyph(const void* face, char32_t c); // returns NULL if the glyph wasn't shared yet
+  void shareGlyph(const void* face, char32_t c, const GlyphPtr& glyph); // remembers the glyphs page and rect for other sizes of face
+  
+  uint32_t currentPage() { return (uint32_t)pages.size()-1; }
+  const TexturePtr& texture(uint32_t page) { return pages[page].texture; }
+  
+  Vec2          pageSize;
+  GLenum        format; // GL_ALPHA only stores coverage and needs a shader like resources/glsl/text. GL_RGBA stores white glyphs with premultiplied alpha
+  GLint         filter;
+  vector<Page>  pages;
+  
+private:
+  void newPage();
+  
+  map<pair<const void*, char32_t>, SharedGlyph> _sharedGlyphs;
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@ void HostBuffer::init(const BufferLayout& inLayout)
   layout = inLayout;
   buffer = NULL;
   count = 0;
+  capacity = 0;
 }
 
 HostBuffer::HostBuffer(const BufferLayout& inLayout)
@@ -48,20 +49,18 @@ void HostBuffer::deleteBuffer()
 //    DOUT("deleting partition " << i);
   free(buffer);
   buffer = NULL;
+  capacity = 0;
 }  
 
-// resizes the buffer to accomodate num structs with the current layout. if num is 0, the buffer will be cleared
+// resizes the buffer to accomodate num structs with the current layout. memory is only reallocated if the capacity is exceeded
 void HostBuffer::reset(uint32_t num)
 {
-  if(num == 0)
-  {
-    deleteBuffer();
-  }
-  else
+  if(num > capacity)
   {
     deleteBuffer();
     uint32_t s = layout.size() *num;
     buffer = (uint8_t*)malloc(s);
+    capacity = num;
 //      DOUT("allocated p:"<<i<<" num:"<<num<<" bytes:"<<s);
   }
   count = num;
@@ -69,10 +68,30 @@ void HostBuffer::reset(uint32_t num)
 
 void HostBuffer::reset(DataPtr data)
 {
-  deleteBuffer();
-  buffer = (uint8_t*)malloc(data->size);
-  memcpy(buffer, data->bytes.get(), data->size);
-  count = (uint32_t)(data->size / layout.size());
+  reset((uint32_t)(data->size / layout.size()));
+  memcpy(buffer, data->bytes.get(), count*layout.size());
+}
+
+void HostBuffer::reserve(uint32_t num)
+{
+  if(num > capacity)
+  {
+    buffer = (uint8_t*)realloc(buffer, layout.size()*num);
+    capacity = num;
+  }
+}
+
+void HostBuffer::shrinkToFit()
+{
+  if(count == 0)
+  {
+    deleteBuffer();
+  }
+  else if(count < capacity)
+  {
+    buffer = (uint8_t*)realloc(buffer, layout.size()*count);
+    capacity = count;
+  }
 }
   
   
@@ -83,23 +102,17 @@ uint32_t HostBuffer::bufferSize()
 
 ElementType HostBuffer::elementTypeFromUsageType(UsageType ut)
 {
-  return layout.ut2et[ut];
+  return layout.entries[ut].elementType;
 }
 
 uint8_t* HostBuffer::elementAddress(uint32_t idx, UsageType ut)
 {
-  uint8_t* result = 0;
-  
-  uint32_t size = layout.size();
-  uint32_t offset = (uint32_t)layout.offset(ut);
-  result = buffer + size*idx +offset; // this is the start of the vertex partition with the given index
-  
-  return result;
+  return buffer + layout.size()*idx + layout.entries[ut].offset;
 }
 
 void HostBuffer::set(uint32_t idx, UsageType ut, uint8_t val)
 {
-  ElementType et = layout.ut2et[ut];
+  ElementType et = layout.entries[ut].elementType;
   switch(et)
   {
     case ET_u8:
@@ -128,7 +141,7 @@ void HostBuffer::set(uint32_t idx, UsageType ut, uint8_t val)
 
 void HostBuffer::set(uint32_t idx, UsageType ut, uint16_t val)
 {
-  ElementType et = layout.ut2et[ut];
+  ElementType et = layout.entries[ut].elementType;
   switch(et)
   {
     case ET_u8:
@@ -157,7 +170,7 @@ void HostBuffer::set(uint32_t idx, UsageType ut, uint16_t val)
 
 void HostBuffer::set(uint32_t idx, UsageType ut, uint32_t val)
 {
-  ElementType et = layout.ut2et[ut];
+  ElementType et = layout.entries[ut].elementType;
   switch(et)
   {
     case ET_u8:
@@ -240,7 +253,7 @@ bool HostBuffer::hasUsageType(UsageType ut)
 
 uint32_t HostBuffer::numScalarsForUsageType(UsageType ut)
 {
-  ElementType et = layout.ut2et[ut];
+  ElementType et = layout.entries[ut].elementType;
   return numScalarsForElementType(et);
 }
 
@@ -27,6 +27,7 @@ struct HostBuffer
   BufferLayout  layout;
   uint8_t*      buffer; // the actual physical buffer
   uint32_t      count; // number of vertices/indices in this HostBuffer
+  uint32_t      capacity; // number of vertices/indices the allocated buffer can hold, never less than count
   
   void init(const BufferLayout& inLayout);
   HostBuffer(const BufferLayout& inLayout);
@@ -36,9 +37,12 @@ struct HostBuffer
   uint32_t bufferSize(); // returns buffersize in bytes calculated from bufferlayout isze and count
   
   
-  // resizes the buffer to accomodate num structs with the current layout. if num is 0, the buffer will be cleared
+  // resizes the buffer to accomodate num structs with the current layout. 
+  // Memory is only reallocated if num exceeds the capacity, the contents are undefined afterwards in any case.
   void reset(uint32_t num);
   void reset(DataPtr data);
+  void reserve(uint32_t num); // grows the capacity to at least num structs, keeping the current contents
+  void shrinkToFit(); // reduces the capacity to count, freeing the buffer if count is 0
   unsigned char* elementAddress(uint32_t idx, UsageType ut); 
   ElementType elementTypeFromUsageType(UsageType ut);
   void set(uint32_t idx, UsageType ut, uint8_t val);
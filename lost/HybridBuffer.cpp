@@ -25,7 +25,10 @@ namespace lost
 HybridBuffer::HybridBuffer()
 {
   gpuBufferType = 0; // this is invalid! you MUST call init after constructing it to initialise this parameter properly.
+  usage = GL_STATIC_DRAW;
   dirty = false;
+  dirtyBegin = 0;
+  dirtyEnd = 0;
 }
 
 HybridBuffer::~HybridBuffer()
@@ -42,6 +45,8 @@ void HybridBuffer::init(GLenum inGpuBufferType,
   gpuBuffer->target = inGpuBufferType;
 
   dirty = false;  
+  dirtyBegin = 0;
+  dirtyEnd = 0;
   vertexAttributeMap[UT_position] = "position";
   vertexAttributeMap[UT_normal] = "normal";
   vertexAttributeMap[UT_texcoord0] = "texcoord0";
@@ -55,12 +60,39 @@ void HybridBuffer::init(GLenum inGpuBufferType,
 void HybridBuffer::reset(uint32_t num)
 {
   hostBuffer->reset(num);
-  dirty = true;
+  touchAll();
 }
 
 void HybridBuffer::reset(DataPtr data)
 {
   hostBuffer->reset(data);
+  touchAll();
+}
+
+void HybridBuffer::reserve(uint32_t num)
+{
+  hostBuffer->reserve(num);
+}
+
+void HybridBuffer::shrinkToFit()
+{
+  hostBuffer->shrinkToFit();
+  touchAll();
+}
+
+void HybridBuffer::modified(uint32_t begin, uint32_t end)
+{
+  if(begin < end)
+  {
+    touch(begin);
+    touch(end-1);
+  }
+}
+
+void HybridBuffer::touchAll()
+{
+  dirtyBegin = 0;
+  dirtyEnd = hostBuffer->count;
   dirty = true;
 }
   
@@ -68,49 +100,49 @@ void HybridBuffer::reset(DataPtr data)
 void HybridBuffer::set(uint32_t idx, UsageType ut, uint8_t val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, uint16_t val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, uint32_t val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, float val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, const Vec2& val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, const Vec3& val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, const Vec4& val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 void HybridBuffer::set(uint32_t idx, UsageType ut, const Color& val)
 {
   hostBuffer->set(idx, ut, val);
-  dirty = true;
+  touch(idx);
 }
 
 Vec2 HybridBuffer::getAsVec2(uint32_t idx, UsageType ut)
@@ -139,11 +171,42 @@ void HybridBuffer::upload()
   buffer->bind();
 // FIXME: need to call bind in Context before uploading
 //  Context::getCurrent()->bind(buffer);
-  buffer->bufferData(buffer->target, 
-                     hostBuffer->count*hostBuffer->layout.size(), 
-                     hostBuffer->buffer,
-                     GL_STATIC_DRAW); // FIXME: this parameter should probably be configurable
+  uint32_t elementSize = hostBuffer->layout.size();
+  GLsizeiptr hostCapacity = hostBuffer->capacity*elementSize;
+  if((buffer->capacity == hostCapacity) && (hostCapacity > 0) && (usage == GL_STREAM_DRAW))
+  {
+    // stream buffers are rewritten every frame or batch, while the gpu might still read the previous contents.
+    // orphaning the storage first lets the driver hand out fresh memory instead of waiting for the pending draws,
+    // which matters most on tile based gpus. the old contents are gone afterwards, so everything up to count is sent
+    buffer->bufferData(buffer->target, hostCapacity, NULL, usage);
+    if(hostBuffer->count > 0)
+    {
+      buffer->bufferSubData(buffer->target, 0, hostBuffer->count*elementSize, hostBuffer->buffer);
+    }
+  }
+  else if((buffer->capacity == hostCapacity) && (hostCapacity > 0))
+  {
+    // the gpu buffer mirrors the host allocation, only send the modified elements
+    uint32_t end = std::min(dirtyEnd, hostBuffer->count);
+    if(end > dirtyBegin)
+    {
+      buffer->bufferSubData(buffer->target,
+                            dirtyBegin*elementSize,
+                            (end-dirtyBegin)*elementSize,
+                            hostBuffer->buffer+(dirtyBegin*elementSize));
+    }
+  }
+  else
+  {
+    // (re)create the gpu storage with the full host capacity, so it only grows along with the host buffer
+    buffer->bufferData(buffer->target, 
+                       hostCapacity, 
+                       hostBuffer->buffer,
+                       usage);
+  }
   dirty = false;
+  dirtyBegin = hostBuffer->count;
+  dirtyEnd = 0;
 }
 
 bool HybridBuffer::hasUsageType(UsageType ut)
@@ -39,6 +39,8 @@ struct HybridBuffer
   
   void reset(uint32_t num);
   void reset(DataPtr data);
+  void reserve(uint32_t num); // see HostBuffer, the gpu buffer follows the host capacity on the next upload
+  void shrinkToFit();
   
   void set(uint32_t idx, UsageType ut, uint8_t val);
   void set(uint32_t idx, UsageType ut, uint16_t val);
@@ -54,16 +56,29 @@ struct HybridBuffer
   uint32_t getAsU32(uint32_t idx, UsageType ut);
   uint16_t getAsU16(uint32_t idx, UsageType ut);
   
-  void upload();
+  void modified(uint32_t begin, uint32_t end); // marks elements [begin, end) for upload after writing to hostBuffer directly, e.g. through a VertexLayout view
+  void upload(); // only uploads the modified range if the host capacity didn't change since the last upload. GL_STREAM_DRAW buffers are orphaned and sent up to count instead
   
   bool hasUsageType(UsageType ut);
   const AttributePointerConfig& pointerConfigForUsageType(UsageType ut);
   
   GLenum gpuBufferType; // should be either GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+  GLenum usage; // GL_STATIC_DRAW (default), GL_DYNAMIC_DRAW or GL_STREAM_DRAW, used for the next full upload
   bool dirty;
+  uint32_t dirtyBegin; // first element modified since the last upload
+  uint32_t dirtyEnd; // one past the last element modified since the last upload
   HostBufferPtr hostBuffer;
   BufferPtr     gpuBuffer;
   VertexAttributeMap vertexAttributeMap; // maps a usageType to a shader vertex attribute name
+  
+private:
+  void touch(uint32_t idx) // adds idx to the dirty range
+  {
+    if(idx < dirtyBegin) { dirtyBegin = idx; }
+    if(idx >= dirtyEnd) { dirtyEnd = idx+1; }
+    dirty = true;
+  }
+  void touchAll();
 };
 
 struct HybridIndexBuffer : HybridBuffer
@@ -17,6 +17,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lost/Mesh.h"
 #include "lost/HostBuffer.h"
 #include "lost/HybridBuffer.h"
+#include "lost/Context.h"
 
 namespace lost
 {
@@ -34,6 +35,12 @@ Mesh::Mesh(const BufferLayout& vertexLayout, ElementType indexType)
   init(vertexLayout, indexType);
 }
 
+Mesh::Mesh(const BufferLayout& vertexLayout)
+{
+  init(vertexLayout, ET_u16);
+  autoIndexType = true;
+}
+
 Mesh::~Mesh() 
 {
 //  DOUT("destroying mesh");
@@ -44,21 +51,78 @@ void Mesh::init(const BufferLayout& vertexLayout, ElementType indexType)
 //  DOUT("creating mesh");
   material = Material::create();
   transform.initIdentity();
+  autoIndexType = false;
   resetBuffers(vertexLayout, indexType);
 }
 
+// drawing with u32 indices fails with GL_INVALID_ENUM on GLES2 without GL_OES_element_index_uint, e.g. on the Raspberry Pi
+static ElementType u32IndexType(uint32_t numVertices)
+{
+  ASSERT(hasElementIndexUint(), "mesh with "<<numVertices<<" vertices needs 32 bit indices, but GL_OES_element_index_uint is not available");
+  return ET_u32;
+}
+
+ElementType Mesh::indexTypeForVertexCount(uint32_t numVertices)
+{
+  if(numVertices <= 0x100) { return ET_u8; }
+  else if(numVertices <= 0x10000) { return ET_u16; }
+  else { return u32IndexType(numVertices); }
+}
+
 void Mesh::resetBuffers(const BufferLayout& vertexLayout, ElementType indexType)
 {
   vertexBuffer.reset(new HybridVertexBuffer(vertexLayout));
   indexBuffer.reset(new HybridIndexBuffer(indexType));
+  indexCount = -1;
 }
 
 void Mesh::resetSize(uint32_t numVertices, uint32_t numIndices)
 {
   vertexBuffer->reset(numVertices);
+  
+  ElementType indexType = indexBuffer->hostBuffer->layout.entries[UT_index].elementType;
+  if(autoIndexType)
+  {
+    indexType = indexTypeForVertexCount(numVertices);
+  }
+  // never resize the shared quad indices, and replace the index buffer if its type changed
+  if((indexCount >= 0) || (indexType != indexBuffer->hostBuffer->layout.entries[UT_index].elementType))
+  {
+    HybridIndexBufferPtr ib(new HybridIndexBuffer(indexType));
+    ib->drawMode = indexBuffer->drawMode;
+    ib->usage = indexBuffer->usage;
+    indexBuffer = ib;
+    indexCount = -1;
+  }
   indexBuffer->reset(numIndices);
 }
 
+void Mesh::shareQuadIndices(uint32_t numQuads)
+{
+  if(numQuads <= Context::maxSharedQuads)
+  {
+    indexBuffer = Context::instance()->quadIndices(numQuads);
+    indexCount = numQuads*6;
+  }
+  else
+  {
+    indexBuffer.reset(new HybridIndexBuffer(u32IndexType(numQuads*4)));
+    indexBuffer->reset(numQuads*6);
+    for(uint32_t i=0; i<numQuads; ++i)
+    {
+      uint32_t idx = i*6;
+      uint32_t v = i*4;
+      indexBuffer->set(idx+0, UT_index, v+0);
+      indexBuffer->set(idx+1, UT_index, v+1);
+      indexBuffer->set(idx+2, UT_index, v+2);
+      indexBuffer->set(idx+3, UT_index, v+2);
+      indexBuffer->set(idx+4, UT_index, v+3);
+      indexBuffer->set(idx+5, UT_index, v+0);
+    }
+    indexCount = -1;
+  }
+}
+
 HybridBufferPtr Mesh::bufferFromUsageType(UsageType ut)
 {
   if(ut == UT_index)
@@ -109,6 +173,8 @@ MeshPtr Mesh::clone()
   result->transform = transform;
   result->vertexBuffer = vertexBuffer;
   result->indexBuffer = indexBuffer;
+  result->autoIndexType = autoIndexType;
+  result->indexCount = indexCount;
   
   return result;
 }
@@ -120,7 +186,7 @@ uint32_t Mesh::numVertices()
 
 uint32_t Mesh::numIndices()
 {
-  return indexBuffer->hostBuffer->count;
+  return (indexCount >= 0) ? indexCount : indexBuffer->hostBuffer->count;
 }
 
 }
@@ -26,19 +26,28 @@ struct Mesh
 {
   Mesh();
   Mesh(const BufferLayout& vertexLayout, ElementType indexType);
+  Mesh(const BufferLayout& vertexLayout); // the index type is chosen by resetSize from the number of vertices
   // completely initializes the mesh object with default values. This is usually called from a constructor
   void init(const BufferLayout& vertexLayout, ElementType indexType);
   virtual ~Mesh();
   
   static MeshPtr create() { return MeshPtr(new Mesh); }
   static MeshPtr create(const BufferLayout& vertexLayout, ElementType indexType) { return MeshPtr(new Mesh(vertexLayout, indexType)); }
+  static MeshPtr create(const BufferLayout& vertexLayout) { return MeshPtr(new Mesh(vertexLayout)); }
+  
+  static ElementType indexTypeForVertexCount(uint32_t numVertices); // returns the smallest of u8, u16, u32 that can address numVertices, asserts if u32 is needed but not supported
   
   // resets the buffer types, throwing away all previously stored/allocated data. you need to call resetSize after this one.
   void resetBuffers(const BufferLayout& vertexLayout, ElementType indexType);
 
   // resets the size of vertex and index buffers
+  // replaces the index buffer if the mesh was sharing quad indices, or the automatic index type changed
   void resetSize(uint32_t numVertices, uint32_t numIndices);
 
+  // points indexBuffer at the quad indices shared by all quad based meshes (see Context::quadIndices) and draws numQuads quads from it.
+  // meshes with more quads than the shared buffer can address get a private u32 index buffer instead.
+  void shareQuadIndices(uint32_t numQuads);
+
   // helper functions that could easily be replaced by direct access of buffers but were needed for migration
   // FIXME: these are here for legacy reasons, should really be replaced with the versions below
   void setIndex(uint32_t idx, uint32_t val);
@@ -66,10 +75,12 @@ struct Mesh
   Matrix transform;
   HybridVertexBufferPtr vertexBuffer;
   HybridIndexBufferPtr indexBuffer;
+  bool autoIndexType; // true if resetSize picks the index type
+  int32_t indexCount; // number of indices to draw, -1 draws all of indexBuffer. shared quad indices usually hold more than one mesh needs
   
   virtual MeshPtr clone();
   uint32_t numVertices(); // returns the current size of the vertexbuffer
-  uint32_t numIndices();
+  uint32_t numIndices(); // returns the number of indices that are drawn
 };
 
 }
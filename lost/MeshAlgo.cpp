@@ -14,8 +14,7 @@ MeshPtr newTriangleStrip(u32 numTriangles)
   BufferLayout layout;
   layout.add(ET_vec2_f32, UT_position);
   layout.add(ET_vec2_f32, UT_texcoord0);  
-  result = Mesh::create(layout, ET_u16);
-  result->indexBuffer->drawMode = GL_TRIANGLE_STRIP;
+  result = Mesh::create(layout);
   
   u32 numVertices = numTriangles + 2;
   u32 numIndices = numVertices;
@@ -25,8 +24,8 @@ MeshPtr newTriangleStrip(u32 numTriangles)
   DOUT("numVertices "<< numVertices);
   DOUT("numIndices "<< numIndices);*/
   
-  result->vertexBuffer->reset(numVertices);
-  result->indexBuffer->reset(numIndices);
+  result->resetSize(numVertices, numIndices);
+  result->indexBuffer->drawMode = GL_TRIANGLE_STRIP;
   
   for(u32 i=0; i<numIndices; ++i)
   {
@@ -42,14 +41,13 @@ MeshPtr newLineStrip(uint16_t numVerts)
 
   BufferLayout layout;
   layout.add(ET_vec2_f32, UT_position);
-  result = Mesh::create(layout, ET_u16);
-  result->indexBuffer->drawMode = GL_LINE_STRIP;
+  result = Mesh::create(layout);
 
   uint32_t numVertices = numVerts;
   uint32_t numIndices = numVertices;
   
-  result->vertexBuffer->reset(numVertices);
-  result->indexBuffer->reset(numIndices);
+  result->resetSize(numVertices, numIndices);
+  result->indexBuffer->drawMode = GL_LINE_STRIP;
   
   for(uint16_t i=0; i<numIndices; ++i)
   {
@@ -67,14 +65,13 @@ MeshPtr newLineGroup(uint16_t numLines)
 
   BufferLayout layout;
   layout.add(ET_vec2_f32, UT_position);
-  result = Mesh::create(layout, ET_u16);
-  result->indexBuffer->drawMode = GL_LINES;
+  result = Mesh::create(layout);
 
   uint32_t numVertices = numLines*2;
   uint32_t numIndices = numVertices;
   
-  result->vertexBuffer->reset(numVertices);
-  result->indexBuffer->reset(numIndices);
+  result->resetSize(numVertices, numIndices);
+  result->indexBuffer->drawMode = GL_LINES;
   
   for(uint16_t i=0; i<numIndices; ++i)
   {
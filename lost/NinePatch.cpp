@@ -60,16 +60,15 @@ void NinePatch::init()
   layout.add(ET_vec2_f32, UT_position);
   layout.add(ET_vec2_f32, UT_texcoord0);
   this->resetBuffers(layout, ET_u16);
-
-  indexBuffer->drawMode = GL_TRIANGLES;
+  autoIndexType = true;
 
   u32 numVertices = 16; // draw it on paper and you'll see it's correct
   uint32_t numQuads = 9; // it's a 3x3 matrix of quads
   uint32_t numTris = numQuads*2; // each quad is drawn with two tris
   u32 numIndices = numTris*3; // currently, each tri is drawn with 3 indices
 
-  this->vertexBuffer->reset(numVertices);
-  this->indexBuffer->reset(numIndices);
+  this->resetSize(numVertices, numIndices);
+  indexBuffer->drawMode = GL_TRIANGLES;
 
 //  updateTexCoords();
   updateIndices();
@@ -16,107 +16,52 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "lost/Quad.h"
 #include "lost/HybridBuffer.h"
+#include "lost/HostBuffer.h"
 
 namespace lost
 {
 
 Quad::Quad()
 {
-  BufferLayout layout;
-  layout.add(ET_vec2_f32, UT_position);
-  layout.add(ET_vec3_f32, UT_normal);
-  layout.add(ET_vec2_f32, UT_texcoord0);
-  this->resetBuffers(layout, ET_u16);
+  this->resetBuffers(Layout::bufferLayout(), ET_u16);
 
   indexBuffer->drawMode = GL_TRIANGLES;
 }
 
 Quad::Quad(const Rect& inRect)
 {
-  BufferLayout layout;
-  layout.add(ET_vec2_f32, UT_position);
-  layout.add(ET_vec3_f32, UT_normal);
-  layout.add(ET_vec2_f32, UT_texcoord0);
-  this->resetBuffers(layout, ET_u16);
-  
-  indexBuffer->drawMode = GL_TRIANGLES;
-  uint32_t numQuads = 1;
-  uint32_t numVertices = numQuads*4;
-  uint32_t numIndices = numQuads*6;
-  
-  this->vertexBuffer->reset(numVertices);
-  this->indexBuffer->reset(numIndices);
-  
-  createIndices(0);
+  resetQuadBuffers(1);
   createVertices(0,inRect);
 }
 
 Quad::Quad(const DataPtr& data, bool flip)
 {
-  BufferLayout layout;
-  layout.add(ET_vec2_f32, UT_position);
-  layout.add(ET_vec3_f32, UT_normal);
-  layout.add(ET_vec2_f32, UT_texcoord0);
-  this->resetBuffers(layout, ET_u16);
-
-  indexBuffer->drawMode = GL_TRIANGLES;
   TexturePtr tex(new Texture(data));
   Rect rect(0, 0, (float)tex->dataWidth, (float)tex->dataHeight);
   this->material->textures.push_back(tex);
-  uint32_t numQuads = 1;
-  uint32_t numVertices = numQuads*4;
-  uint32_t numIndices = numQuads*6;
-  
-  this->vertexBuffer->reset(numVertices);
-  this->indexBuffer->reset(numIndices);
-  
-  createIndices(0);
+
+  resetQuadBuffers(1);
   createVertices(0, rect);
   createTexCoords(0,flip);
 }
 
 Quad::Quad(const TexturePtr& tex, bool flip)
 {
-  BufferLayout layout;
-  layout.add(ET_vec2_f32, UT_position);
-  layout.add(ET_vec3_f32, UT_normal);
-  layout.add(ET_vec2_f32, UT_texcoord0);
-  this->resetBuffers(layout, ET_u16);
-
-  indexBuffer->drawMode = GL_TRIANGLES;
   Rect rect(0, 0, (float)tex->dataWidth, (float)tex->dataHeight);
   this->material->textures.push_back(tex);
-  uint32_t numQuads = 1;
-  uint32_t numVertices = numQuads*4;
-  uint32_t numIndices = numQuads*6;
-
-  this->vertexBuffer->reset(numVertices);
-  this->indexBuffer->reset(numIndices);
 
-  createIndices(0);
+  resetQuadBuffers(1);
   createVertices(0, rect);
   createTexCoords(0,flip);    
 }
 
 Quad::Quad(const vector<Rect>& rects)
 {
-  BufferLayout layout;
-  layout.add(ET_vec2_f32, UT_position);
-  layout.add(ET_vec3_f32, UT_normal);
-  layout.add(ET_vec2_f32, UT_texcoord0);  
-  this->resetBuffers(layout, ET_u16);
-
-  indexBuffer->drawMode = GL_TRIANGLES;
   size_t numQuads = rects.size();
-  size_t numVertices = numQuads*4;
-  size_t numIndices = numQuads*6;
-
-  this->vertexBuffer->reset((uint32_t)numVertices);
-  this->indexBuffer->reset((uint32_t)numIndices);
+  resetQuadBuffers((uint32_t)numQuads);
 
   for(uint32_t i=0; i<numQuads; ++i)
   {
-    createIndices(i);
     createVertices(i,rects[i]);
   }
 }
@@ -135,28 +80,13 @@ void Quad::init(const vector<Rect>& rects,
           bool flip)
 {
   ASSERT(rects.size() == pixelCoords.size(), "number of rects and pixelCoords must match");
-  if(!indexBuffer or !vertexBuffer)
-  {
-    BufferLayout layout;
-    layout.add(ET_vec2_f32, UT_position);
-    layout.add(ET_vec3_f32, UT_normal);
-    layout.add(ET_vec2_f32, UT_texcoord0);
-    this->resetBuffers(layout, ET_u16);
-  }
-  
-  indexBuffer->drawMode = GL_TRIANGLES;
   this->material->textures.clear();
   this->material->textures.push_back(tex);
   size_t numQuads = rects.size();
-  size_t numVertices = numQuads*4;
-  size_t numIndices = numQuads*6;
-  
-  this->vertexBuffer->reset((uint32_t)numVertices);
-  this->indexBuffer->reset((uint32_t)numIndices);
+  resetQuadBuffers((uint32_t)numQuads);
   
   for(uint32_t i=0; i<numQuads; ++i)
   {
-    createIndices(i);
     createVertices(i, rects[i]);
     createTexCoords(i, 0, pixelCoords[i], flip);
   }
@@ -166,28 +96,28 @@ Quad::~Quad()
 {
 }
 
-void Quad::createIndices(uint32_t quadNum)
-{ 
-  const uint32_t numIndicesPerQuad = 6;
-  uint32_t indexOffset = quadNum*numIndicesPerQuad;
-  uint32_t vertexOffset = quadNum*4;
-  this->setIndex(indexOffset+0, vertexOffset + 0);
-  this->setIndex(indexOffset+1, vertexOffset + 1);
-  this->setIndex(indexOffset+2, vertexOffset + 2);
-  this->setIndex(indexOffset+3, vertexOffset + 2);
-  this->setIndex(indexOffset+4, vertexOffset + 3);
-  this->setIndex(indexOffset+5, vertexOffset + 0);    
+void Quad::resetQuadBuffers(uint32_t numQuads)
+{
+  if(!vertexBuffer or !Layout::matches(vertexBuffer->hostBuffer->layout))
+  {
+    vertexBuffer.reset(new HybridVertexBuffer(Layout::bufferLayout()));
+  }
+  vertexBuffer->reset(numQuads*4);
+  shareQuadIndices(numQuads);
 }
 
 void Quad::createVertices(uint32_t quadNum, const Rect& inRect)
 {
   uint32_t verticesPerQuad = 4;
   uint32_t offset = quadNum*verticesPerQuad;
+  HostBuffer* hb = this->vertexBuffer->hostBuffer.get();
+  StridedView<Vec2> position = Layout::view<UT_position>(hb);
+  StridedView<Vec3> normal = Layout::view<UT_normal>(hb);
 
-  this->setVertex(offset+0, Vec2(inRect.x,inRect.y));
-  this->setVertex(offset+1, Vec2(inRect.x+inRect.width,inRect.y));
-  this->setVertex(offset+2, Vec2(inRect.x+inRect.width,inRect.y+inRect.height));
-  this->setVertex(offset+3, Vec2(inRect.x,inRect.y+inRect.height));
+  position[offset+0] = Vec2(inRect.x,inRect.y);
+  position[offset+1] = Vec2(inRect.x+inRect.width,inRect.y);
+  position[offset+2] = Vec2(inRect.x+inRect.width,inRect.y+inRect.height);
+  position[offset+3] = Vec2(inRect.x,inRect.y+inRect.height);
 
   // calculate normals
   Vec3 v1(inRect.x,inRect.y,0);
@@ -198,10 +128,11 @@ void Quad::createVertices(uint32_t quadNum, const Rect& inRect)
   normalise(normal1);
   Vec3 normal2 = cross(v4-v3, v1-v4);
   normalise(normal2);
-  this->vertexBuffer->set(offset+0, UT_normal, normal1+normal2);
-  this->vertexBuffer->set(offset+1, UT_normal, normal1);
-  this->vertexBuffer->set(offset+2, UT_normal, normal1+normal2);
-  this->vertexBuffer->set(offset+3, UT_normal, normal1);
+  normal[offset+0] = normal1+normal2;
+  normal[offset+1] = normal1;
+  normal[offset+2] = normal1+normal2;
+  normal[offset+3] = normal1;
+  this->vertexBuffer->modified(offset, offset+verticesPerQuad);
 }
             
 void Quad::updateSize(const Vec2& size)
@@ -237,21 +168,23 @@ void Quad::createTexCoords(uint32_t quadNum,
   
   const uint32_t texCoordsPerQuad = 4; 
   uint32_t offset = texCoordsPerQuad*quadNum;
+  StridedView<Vec2> texcoord = Layout::view<UT_texcoord0>(this->vertexBuffer->hostBuffer.get());
   
   if(flip)
   {
-    this->setTexCoord(offset+0, Vec2(bl.x,tr.y));
-    this->setTexCoord(offset+1, Vec2(tr.x,tr.y));
-    this->setTexCoord(offset+2, Vec2(tr.x,bl.y));
-    this->setTexCoord(offset+3, Vec2(bl.x,bl.y));
+    texcoord[offset+0] = Vec2(bl.x,tr.y);
+    texcoord[offset+1] = Vec2(tr.x,tr.y);
+    texcoord[offset+2] = Vec2(tr.x,bl.y);
+    texcoord[offset+3] = Vec2(bl.x,bl.y);
   }
   else
   {
-    this->setTexCoord(offset+0, Vec2(bl.x,bl.y));
-    this->setTexCoord(offset+1, Vec2(tr.x,bl.y));
-    this->setTexCoord(offset+2, Vec2(tr.x,tr.y));
-    this->setTexCoord(offset+3, Vec2(bl.x,tr.y));
+    texcoord[offset+0] = Vec2(bl.x,bl.y);
+    texcoord[offset+1] = Vec2(tr.x,bl.y);
+    texcoord[offset+2] = Vec2(tr.x,tr.y);
+    texcoord[offset+3] = Vec2(bl.x,tr.y);
   }
+  this->vertexBuffer->modified(offset, offset+texCoordsPerQuad);
 }
 
 }
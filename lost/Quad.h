@@ -20,12 +20,15 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lost/Mesh.h"
 #include "lost/Data.h"
 #include "lost/Texture.h"
+#include "lost/VertexLayout.h"
 
 namespace lost
 {
 
 struct Quad : public Mesh
 {
+  typedef VertexLayout<Attr<UT_position, Vec2>, Attr<UT_normal, Vec3>, Attr<UT_texcoord0, Vec2> > Layout;
+  
   Quad();
   Quad(const Rect& inRect);
   
@@ -51,7 +54,7 @@ struct Quad : public Mesh
   
   virtual ~Quad();
   
-  void createIndices(uint32_t quadNum);
+  void resetQuadBuffers(uint32_t numQuads); // resizes the vertex buffer to numQuads and points the mesh at the shared quad indices
   void createVertices(uint32_t quadNum, const Rect& inRect);
   void updateSize(const Vec2& size);
 
@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "lost/QuadBatch.h"
+#include "lost/Context.h"
+#include "lost/HybridBuffer.h"
+#include "lost/HostBuffer.h"
+
+namespace lost
+{
+
+QuadBatch::QuadBatch(Context* ctx)
+{
+  _context = ctx;
+  _blendSrc = GL_ONE;
+  _blendDest = GL_ONE_MINUS_SRC_ALPHA;
+  
+  mesh = Mesh::create(Layout::bufferLayout(), ET_u16);
+  mesh->vertexBuffer->vertexAttributeMap[UT_color] = "color";
+  mesh->vertexBuffer->usage = GL_STREAM_DRAW;
+  mesh->material->color = whiteColor;
+  mesh->material->blendPremultiplied();
+}
+
+void QuadBatch::state(const ShaderProgramPtr& shader, const TexturePtr& tex, GLenum blendSrc, GLenum blendDest)
+{
+  if((shader != _shader) || (tex != _texture) || (blendSrc != _blendSrc) || (blendDest != _blendDest))
+  {
+    flush();
+    _shader = shader;
+    _texture = tex;
+    _blendSrc = blendSrc;
+    _blendDest = blendDest;
+  }
+}
+
+void QuadBatch::addVertex(const Vec2& pos, const Vec2& tc, const Color& col)
+{
+  Vertex v;
+  v.position = pos;
+  v.texcoord = tc;
+  v.color = col;
+  _vertices.push_back(v);
+}
+
+void QuadBatch::add(const Rect& rect, const Color& col, const Vec2& bl, const Vec2& br, const Vec2& tr, const Vec2& tl)
+{
+  if(_vertices.size() >= _maxQuads*4)
+  {
+    flush();
+  }
+  addVertex(Vec2(rect.x, rect.y), bl, col);
+  addVertex(Vec2(rect.x+rect.width, rect.y), br, col);
+  addVertex(Vec2(rect.x+rect.width, rect.y+rect.height), tr, col);
+  addVertex(Vec2(rect.x, rect.y+rect.height), tl, col);
+}
+
+void QuadBatch::add(const Rect& rect, const Color& col)
+{
+  add(rect, col, Vec2(0,0), Vec2(1,0), Vec2(1,1), Vec2(0,1));
+}
+
+void QuadBatch::flush()
+{
+  if(_vertices.empty()) return;
+  
+  u32 numQuads = (u32)_vertices.size() / 4;
+  u32 numVertices = (u32)_vertices.size();
+  
+  // indices are the same for every batch, so all batches draw from the shared quad indices
+  mesh->shareQuadIndices(numQuads);
+  
+  HybridVertexBuffer* vb = mesh->vertexBuffer.get();
+  if(vb->hostBuffer->count != numVertices)
+  {
+    vb->reset(numVertices);
+  }
+  StridedView<Vec2> position = Layout::view<UT_position>(vb->hostBuffer.get());
+  StridedView<Vec2> texcoord = Layout::view<UT_texcoord0>(vb->hostBuffer.get());
+  StridedView<Color> color = Layout::view<UT_color>(vb->hostBuffer.get());
+  for(u32 i=0; i<numVertices; ++i)
+  {
+    const Vertex& v = _vertices[i];
+    position[i] = v.position;
+    texcoord[i] = v.texcoord;
+    color[i] = v.color;
+  }
+  vb->modified(0, numVertices);
+  
+  mesh->material->shader = _shader;
+  mesh->material->limitTextures(0);
+  if(_texture)
+  {
+    mesh->material->setTexture(0, _texture);
+  }
+  mesh->material->blendSrc = _blendSrc;
+  mesh->material->blendDest = _blendDest;
+  _context->draw(mesh);
+  
+  _vertices.clear();
+}
+
+}
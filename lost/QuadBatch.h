@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef LOST_QUADBATCH_H
+#define LOST_QUADBATCH_H
+
+#include "lost/Mesh.h"
+#include "lost/VertexLayout.h"
+#include "lost/Context.h"
+
+namespace lost
+{
+
+/** Collects axis aligned 2D quads with per vertex colors in a single vertex buffer and draws them with as few draw calls as possible.
+ *  Quads are appended until the shader, texture or blend function changes, or flush() is called explicitly.
+ *  Colors are expected to be premultiplied already.
+ *  The batch doesn't know about framebuffers, cameras or the modelview stack. It must be flushed before any of these change,
+ *  and before drawing anything else that has to appear on top of the batched quads.
+ *  The shader must read the per vertex color from an attribute named "color".
+ */
+struct QuadBatch
+{
+  QuadBatch(Context* ctx);
+  
+  // flushes pending quads if the new state differs from the current one. tex may be NULL for untextured shaders.
+  void state(const ShaderProgramPtr& shader, const TexturePtr& tex, GLenum blendSrc, GLenum blendDest);
+  
+  // appends rect with the given texcoords for its bottom left, bottom right, top right and top left corners
+  void add(const Rect& rect, const Color& col, const Vec2& bl, const Vec2& br, const Vec2& tr, const Vec2& tl);
+  void add(const Rect& rect, const Color& col); // texcoords span the whole texture
+  
+  void flush(); // draws all pending quads, does nothing if there are none
+  
+  MeshPtr mesh;
+  
+  typedef VertexLayout<Attr<UT_position, Vec2>, Attr<UT_texcoord0, Vec2>, Attr<UT_color, Color> > Layout;
+  
+private:
+  struct Vertex
+  {
+    Vec2  position;
+    Vec2  texcoord;
+    Color color;
+  };
+  
+  static const u32 _maxQuads = Context::maxSharedQuads;
+  
+  Context*          _context;
+  vector<Vertex>    _vertices; // pending quads, 4 vertices each
+  ShaderProgramPtr  _shader;
+  TexturePtr        _texture;
+  GLenum            _blendSrc;
+  GLenum            _blendDest;
+  
+  void addVertex(const Vec2& pos, const Vec2& tc, const Color& col);
+};
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "lost/RenderQueue.h"
+#include "lost/Mesh.h"
+#include "lost/ShaderProgram.h"
+#include "lost/Texture.h"
+#include <algorithm>
+
+namespace lost
+{
+
+RenderQueue::RenderQueue()
+{
+  _pass = 0;
+  _passTarget = 0;
+}
+
+bool RenderQueue::canAdd(GLuint target)
+{
+  return commands.empty() || (target == _passTarget) || (_pass+1 < maxPasses);
+}
+
+void RenderQueue::add(const MeshPtr& mesh, u16 depth, GLuint target, const CameraPtr& cam, const Matrix& modelView)
+{
+  if(commands.empty())
+  {
+    _pass = 0;
+    _passTarget = target;
+  }
+  else if(target != _passTarget)
+  {
+    ++_pass;
+    _passTarget = target;
+  }
+  
+  RenderCommand cmd;
+  cmd.mesh = mesh;
+  cmd.cam = cam;
+  cmd.target = target;
+  cmd.modelView = modelView;
+  order.push_back(SortEntry(key(mesh.get(), depth, _pass), (u32)commands.size()));
+  commands.push_back(cmd);
+}
+
+void RenderQueue::sort()
+{
+  // the command index is part of the entry, so equal keys retain recording order
+  std::sort(order.begin(), order.end());
+}
+
+void RenderQueue::clear()
+{
+  commands.clear();
+  order.clear();
+}
+
+bool RenderQueue::empty()
+{
+  return commands.empty();
+}
+
+u64 RenderQueue::key(Mesh* mesh, u16 depth, u32 pass)
+{
+  u64 shaderBits = 0;
+  u64 textureBits = 0;
+  u64 blendBits = 0;
+  
+  Material* mat = mesh->material.get();
+  if(mat)
+  {
+    if(mat->shader)
+    {
+      shaderBits = mat->shader->program & 0xfff;
+    }
+    // GL names are small integers, so the first texture usually maps to its name directly
+    for(const TexturePtr& tex : mat->textures)
+    {
+      if(tex)
+      {
+        textureBits = textureBits*31 + tex->texture;
+      }
+    }
+    textureBits &= 0xfffff;
+    if(mat->blend)
+    {
+      blendBits = 0x80 | ((mat->blendSrc*3 + mat->blendDest) & 0x7f);
+    }
+  }
+  
+  return (u64(pass & 0xff) << 56)
+       | (u64(depth) << 40)
+       | (shaderBits << 28)
+       | (textureBits << 8)
+       | blendBits;
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef LOST_RENDERQUEUE_H
+#define LOST_RENDERQUEUE_H
+
+namespace lost
+{
+
+/** A single deferred draw call, recorded by Context::enqueue() and executed by Context::flush().
+ *  The mesh and its material are referenced, not copied, so they must not be modified before the queue was flushed.
+ */
+struct RenderCommand
+{
+  MeshPtr   mesh;
+  CameraPtr cam;        // camera that was active when the command was recorded
+  GLuint    target;     // framebuffer that was bound when the command was recorded
+  Matrix    modelView;  // mesh->transform combined with the modelview stack at the time of recording
+};
+
+/** Collects the RenderCommands of a pass and sorts them by a 64 bit key, so that draws sharing
+ *  shader, textures and blend state end up next to each other and Context can skip the state changes.
+ *
+ *  Key layout, from most to least significant bits:
+ *
+ *    8 bit target pass | 16 bit depth | 12 bit shader | 20 bit texture set | 8 bit blend state
+ *
+ *  The target pass is incremented whenever a command is recorded for a different framebuffer than the previous one,
+ *  so passes are executed in recording order and e.g. an offscreen pass is finished before the pass that samples it.
+ *  depth is provided by the caller and defines the drawing order between groups of commands within a pass. 
+ *  Commands with the same depth may be reordered freely, so only share a depth between draws that don't overlap
+ *  or don't depend on drawing order. Commands with identical keys keep the order they were recorded in.
+ */
+struct RenderQueue
+{
+  typedef pair<u64, u32> SortEntry; // (key, index into commands)
+
+  RenderQueue();
+  
+  void add(const MeshPtr& mesh, u16 depth, GLuint target, const CameraPtr& cam, const Matrix& modelView);
+  bool canAdd(GLuint target); // false if all target passes are used up and target would start a new one, flush first
+  void sort(); // sorts the recorded commands, must be called before iterating over order
+  void clear(); // throws away all recorded commands but keeps the allocated storage for the next pass
+  bool empty();
+
+  static u64 key(Mesh* mesh, u16 depth, u32 pass);
+  static const u32 maxPasses = 256;
+
+  vector<RenderCommand> commands; // in recording order
+  vector<SortEntry>     order; // sorted by key, then recording order
+  
+private:
+  u32     _pass; // index of the current target pass
+  GLuint  _passTarget; // framebuffer of the current target pass
+};
+
+}
+
+#endif
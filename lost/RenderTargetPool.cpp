@@ -0,0 +1,192 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "lost/RenderTargetPool.h"
+#include "lost/FrameBuffer.h"
+#include "lost/Context.h"
+
+namespace lost
+{
+
+static u32 textureBytes(const TexturePtr& texture)
+{
+  return texture->width*texture->height*4; // render targets are always RGBA
+}
+
+// buckets get coarser for larger sizes, so the memory wasted by rounding up stays below a quarter or so
+static u32 bucketLength(f32 length)
+{
+  u32 result = std::max((u32)ceilf(length), (u32)1);
+  u32 step = std::max(nextPowerOf2(result)/4, (u32)32);
+  return ((result+step-1)/step)*step;
+}
+
+RenderTargetPool::RenderTargetPool(u32 inBudget)
+{
+  budget = inBudget;
+  memory = 0;
+  peakMemory = 0;
+  numBorrowed = 0;
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+  purge();
+}
+
+Vec2 RenderTargetPool::bucketSize(const Vec2& size)
+{
+  return Vec2((f32)bucketLength(size.width), (f32)bucketLength(size.height));
+}
+
+bool RenderTargetPool::fits(const TexturePtr& texture, const Vec2& size, bool exactSize)
+{
+  if(exactSize)
+  {
+    return (texture->width == (u32)size.width) && (texture->height == (u32)size.height);
+  }
+  
+  // don't keep huge textures around for small layers
+  Vec2 bucket = bucketSize(size);
+  return (texture->width >= size.width) && (texture->height >= size.height)
+         && (texture->width*texture->height <= 2*bucket.width*bucket.height);
+}
+
+TexturePtr RenderTargetPool::borrow(const Vec2& size, bool exactSize)
+{
+  TexturePtr result;
+  
+  // smallest unused texture that can hold size
+  vector<TexturePtr>::iterator best = _unused.end();
+  for(vector<TexturePtr>::iterator pos=_unused.begin(); pos!=_unused.end(); ++pos)
+  {
+    if(fits(*pos, size, exactSize) && ((best == _unused.end()) || ((*pos)->width*(*pos)->height < (*best)->width*(*best)->height)))
+    {
+      best = pos;
+    }
+  }
+  
+  if(best != _unused.end())
+  {
+    result = *best;
+    _unused.erase(best);
+    ++hits;
+  }
+  else
+  {
+    Vec2 targetSize = exactSize ? Vec2(floorf(size.width), floorf(size.height)) : bucketSize(size);
+    evict((u32)(targetSize.width*targetSize.height*4));
+    result = create(targetSize);
+    ++misses;
+  }
+  
+  result->dataWidth = (u32)size.width;
+  result->dataHeight = (u32)size.height;
+  ++numBorrowed;
+  return result;
+}
+
+void RenderTargetPool::giveBack(const TexturePtr& texture)
+{
+  if(texture)
+  {
+    _unused.push_back(texture);
+    --numBorrowed;
+    evict(0);
+  }
+}
+
+TexturePtr RenderTargetPool::resize(const TexturePtr& texture, const Vec2& size)
+{
+  if(texture && fits(texture, size, false))
+  {
+    texture->dataWidth = (u32)size.width;
+    texture->dataHeight = (u32)size.height;
+    return texture;
+  }
+  giveBack(texture);
+  return borrow(size);
+}
+
+const FrameBufferPtr& RenderTargetPool::framebuffer(const TexturePtr& texture)
+{
+  return _framebuffers[texture.get()];
+}
+
+void RenderTargetPool::bind(const TexturePtr& texture)
+{
+  const FrameBufferPtr& fb = framebuffer(texture);
+  fb->bind();
+#if defined(LOST_GL_DEBUG)
+  fb->check();
+#endif
+}
+
+TexturePtr RenderTargetPool::create(const Vec2& size)
+{
+  TexturePtr result(new Texture(size));
+  memory += textureBytes(result);
+  peakMemory = std::max(peakMemory, memory);
+  
+  // the texture stays attached for its whole lifetime, so this is the only completeness check in release builds
+  FrameBufferPtr fb(new FrameBuffer);
+  fb->size = size;
+  fb->bind();
+  fb->attachColorBuffer(0, result);
+  fb->check();
+  Context::instance()->bindDefaultFramebuffer();
+  _framebuffers[result.get()] = fb;
+  
+  return result;
+}
+
+void RenderTargetPool::destroy(const TexturePtr& texture)
+{
+  memory -= textureBytes(texture);
+  _framebuffers.erase(texture.get());
+}
+
+void RenderTargetPool::evict(u32 requiredBytes)
+{
+  while(_unused.size() && (memory+requiredBytes > budget))
+  {
+    destroy(_unused.front());
+    _unused.erase(_unused.begin());
+    ++evictions;
+  }
+}
+
+void RenderTargetPool::purge()
+{
+  for(vector<TexturePtr>::iterator pos=_unused.begin(); pos!=_unused.end(); ++pos)
+  {
+    destroy(*pos);
+  }
+  evictions += (u32)_unused.size();
+  _unused.clear();
+}
+
+void RenderTargetPool::logStats()
+{
+  DOUT("render targets: borrowed "<<numBorrowed<<" unused "<<(u32)_unused.size()<<" mem: "<<memory/1024<<"/"<<budget/1024<<" kb peak: "<<peakMemory/1024<<" kb");
+  DOUT("render targets: hits "<<hits<<" misses "<<misses<<" evictions "<<evictions);
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef LOST_RENDERTARGETPOOL_H
+#define LOST_RENDERTARGETPOOL_H
+
+namespace lost
+{
+
+/** Textures for rendering into, that are reused instead of being created or resized for every layer cache or canvas.
+ *  Sizes are rounded up to buckets, so animating the size of a layer only occasionally needs a new texture.
+ *  A borrowed texture may be larger than requested, its dataWidth and dataHeight are set to the requested size, 
+ *  so Quads and DrawContext::drawTexturedRect only draw that part.
+ *  Every texture comes with its own FrameBuffer that it stays attached to, so switching render targets is a plain bind,
+ *  and completeness is only validated once when the target is created.
+ *  Unused textures are freed as soon as the pool exceeds its memory budget.
+ */
+struct RenderTargetPool
+{
+  RenderTargetPool(u32 inBudget = 64*1024*1024);
+  ~RenderTargetPool();
+  
+  // exactSize is for targets whose shaders depend on the texel size
+  TexturePtr borrow(const Vec2& size, bool exactSize = false);
+  void giveBack(const TexturePtr& texture);
+  
+  // returns texture if it can hold size, otherwise gives it back and borrows one that can. texture may be NULL.
+  TexturePtr resize(const TexturePtr& texture, const Vec2& size);
+  
+  const FrameBufferPtr& framebuffer(const TexturePtr& texture); // texture must have been borrowed from this pool
+  void bind(const TexturePtr& texture); // binds the framebuffer of texture, only revalidated with LOST_GL_DEBUG
+  
+  void purge(); // frees all unused textures
+  void logStats();
+  
+  static Vec2 bucketSize(const Vec2& size);
+  
+  u32 budget; // in bytes
+  u32 memory; // of all textures created by the pool, borrowed or unused
+  u32 peakMemory;
+  u32 numBorrowed;
+  u32 hits; // borrowed textures that were reused
+  u32 misses; // borrowed textures that had to be created
+  u32 evictions;
+  
+private:
+  vector<TexturePtr> _unused; // least recently given back first
+  map<Texture*, FrameBufferPtr> _framebuffers; // for all textures created by the pool
+  
+  TexturePtr create(const Vec2& size);
+  void destroy(const TexturePtr& texture);
+  
+  bool fits(const TexturePtr& texture, const Vec2& size, bool exactSize);
+  void evict(u32 requiredBytes); // frees unused textures until requiredBytes fit into the budget
+};
+
+}
+
+#endif
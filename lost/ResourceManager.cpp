@@ -3,6 +3,7 @@
 #include "lost/BitmapIo.h"
 #include "lost/Texture.h"
 #include "lost/TruetypeFont.h"
+#include "lost/GlyphAtlas.h"
 #include "lost/StringAdditions.h"
 
 namespace lost
@@ -269,20 +270,21 @@ void ResourceManager::registerFontBundle(const string& fontBundlePath)
   }
 }
 
-FontPtr ResourceManager::font(const string& fontName, u32 fontSize)
+FontPtr ResourceManager::font(const string& fontName, u32 fontSize, bool signedDistanceField)
 {
-  return font(hashPath(fontName), fontSize);
+  return font(hashPath(fontName), fontSize, signedDistanceField);
 }
 
-FontPtr ResourceManager::font(ResourceId rid, u32 fontSize)
+FontPtr ResourceManager::font(ResourceId rid, u32 fontSize, bool signedDistanceField)
 {
   FontPtr result;
   
   ASSERT(fontId2dataPath.find(rid) != fontId2dataPath.end(), "can't find font data path for font with id:"<<rid<<" -> " << hash2string[rid]);
   pair<ResourceId, u32> fontKey = make_pair(rid, fontSize);
+  map<pair<ResourceId, u32>, FontPtr>& fonts = signedDistanceField ? fontIdSize2sdfFont : fontIdSize2font;
   
-  map<pair<ResourceId, u32>, FontPtr>::iterator fontPos = fontIdSize2font.find(fontKey);
-  if(fontPos == fontIdSize2font.end())
+  map<pair<ResourceId, u32>, FontPtr>::iterator fontPos = fonts.find(fontKey);
+  if(fontPos == fonts.end())
   {
     DOUT("no font yet for "<<hash2string[rid]<<" in size "<<fontSize<<" , creating");
     // no font instance for this key => check if data was already loaded
@@ -300,12 +302,17 @@ FontPtr ResourceManager::font(ResourceId rid, u32 fontSize)
       data = fontId2data[rid];
     }
     // instantiate font with data and size and put it into map
-    result.reset(new TruetypeFont(data, fontSize));
-    fontIdSize2font[fontKey] = result;
+    GlyphAtlasPtr& atlas = signedDistanceField ? sdfGlyphAtlas : glyphAtlas;
+    if(!atlas)
+    {
+      atlas = GlyphAtlas::create(Vec2(512, 512), GL_ALPHA, signedDistanceField ? GL_LINEAR : GL_NEAREST);
+    }
+    result.reset(new TruetypeFont(data, fontSize, atlas, signedDistanceField));
+    fonts[fontKey] = result;
   }
   else
   {
-    result = fontIdSize2font[fontKey];
+    result = fontPos->second;
   }
   return result;
 }
@@ -319,6 +326,9 @@ void ResourceManager::logStats()
   DOUT("font names: "<<(u32)fontId2dataPath.size());
   DOUT("font data loaded: "<<(u32)fontId2data.size());
   DOUT("fonts instantiated: "<<(u32)fontIdSize2font.size());
+  DOUT("distance field fonts instantiated: "<<(u32)fontIdSize2sdfFont.size());
+  DOUT("glyph atlas pages: "<<(glyphAtlas ? (u32)glyphAtlas->pages.size() : 0));
+  DOUT("distance field glyph atlas pages: "<<(sdfGlyphAtlas ? (u32)sdfGlyphAtlas->pages.size() : 0));
   DOUT("hashed resource paths: "<<(u32)hash2string.size());
   for(map<ResourceId, string>::iterator pos = hash2string.begin(); pos != hash2string.end(); ++pos)
   {
@@ -38,8 +38,9 @@ struct ResourceManager
   // then access the fonts that are defined in the bundles via font(name, size)
   // only supports truetype fonts for now
   void registerFontBundle(const string& fontBundlePath); // reads the meta.json file and registers the font names
-  FontPtr font(const string& fontName, u32 fontSize); // loads the font with given name and instantiates a truetype font with the specified size, caching the font
-  FontPtr font(ResourceId rid, u32 fontSize); // same as above, with resourceId instead of fontName
+  FontPtr font(const string& fontName, u32 fontSize, bool signedDistanceField = false); // loads the font with given name and instantiates a truetype font with the specified size, caching the font
+  FontPtr font(ResourceId rid, u32 fontSize, bool signedDistanceField = false); // same as above, with resourceId instead of fontName
+                                                                                // distance field fonts share their glyphs between all sizes of a face
   
   void logStats();
 
@@ -66,6 +67,9 @@ private:
   map<ResourceId, Path>             fontId2dataPath;
   map<ResourceId, DataPtr>            fontId2data;
   map<pair<ResourceId, u32>, FontPtr> fontIdSize2font;
+  map<pair<ResourceId, u32>, FontPtr> fontIdSize2sdfFont;
+  GlyphAtlasPtr                       glyphAtlas; // shared by all fonts, so text in any font and size can use the same texture
+  GlyphAtlasPtr                       sdfGlyphAtlas; // same for distance field fonts, which need linear filtering
 };
 }
 
@@ -22,9 +22,25 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace lost
 {
 
+static const char* builtinUniformNames[BuiltinUniformCount] =
+{
+  "projectionMatrix",
+  "modelViewMatrix",
+  "viewport",
+  "depth",
+  "color",
+  "texture0",
+  "texture1",
+  "texture2"
+};
+
 ShaderProgram::ShaderProgram()
 {
   program = glCreateProgram();GLASSERT;
+  for(u32 i=0; i<BuiltinUniformCount; ++i)
+  {
+    builtinUniforms[i] = NULL;
+  }
 }
 
 ShaderProgram::~ShaderProgram()
@@ -48,6 +64,26 @@ Uniform& ShaderProgram::uniform(const string& inName)
   }
 }
 
+Uniform& ShaderProgram::uniform(UniformHandle handle)
+{
+  ASSERT((handle >= 0) && (handle < (UniformHandle)handle2uniform.size()), "invalid uniform handle: "<<handle);
+  return *handle2uniform[handle];
+}
+
+UniformHandle ShaderProgram::uniformHandle(const string& inName)
+{
+  UniformHandle result = UniformHandleInvalid;
+  for(u32 i=0; i<handle2uniform.size(); ++i)
+  {
+    if(handle2uniform[i]->name == inName)
+    {
+      result = i;
+      break;
+    }
+  }
+  return result;
+}
+
 Uniform& ShaderProgram::operator[](const string& inName)
 {
   return uniform(inName);
@@ -162,9 +198,22 @@ void ShaderProgram::buildUniformMap()
     glGetActiveUniform(program, i, bufferSize, &writtenBytes, &size, &type, buffer.get());
     GLint loc = glGetUniformLocation(program, buffer.get());
     Uniform uniform(buffer.get(), i, type, size, loc);
+    uniform.stats = &uniformStats;
     name2uniform[uniform.name] = uniform;
 //    DOUT(i << " : " << string(buffer.get(), buffer.get()+writtenBytes) << " size:"<<size << " type:"<<lost::gl::utils::enum2string(type)<<" location:"<<loc);
   }
+
+  // map nodes are stable, so handles and builtin slots can point into name2uniform until it is rebuilt
+  handle2uniform.clear();
+  for(UniformMap::iterator i=name2uniform.begin(); i!=name2uniform.end(); ++i)
+  {
+    handle2uniform.push_back(&(i->second));
+  }
+  for(u32 i=0; i<BuiltinUniformCount; ++i)
+  {
+    UniformMap::iterator pos = name2uniform.find(builtinUniformNames[i]);
+    builtinUniforms[i] = (pos != name2uniform.end()) ? &(pos->second) : NULL;
+  }
 }
 
 void ShaderProgram::buildVertexAttributeMap()
@@ -23,6 +23,25 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace lost
 {
 
+// uniforms that Context::draw sets automatically if a shader declares them.
+// They are resolved once per link by buildUniformMap(), so drawing doesn't need any name lookups.
+enum BuiltinUniform
+{
+  BuiltinUniformProjectionMatrix = 0,
+  BuiltinUniformModelViewMatrix,
+  BuiltinUniformViewport,
+  BuiltinUniformDepth,
+  BuiltinUniformColor,
+  BuiltinUniformTexture0,
+  BuiltinUniformTexture1,
+  BuiltinUniformTexture2,
+  BuiltinUniformCount
+};
+
+// index of a uniform within a ShaderProgram, returned by ShaderProgram::uniformHandle().
+typedef s32 UniformHandle;
+const static UniformHandle UniformHandleInvalid = -1;
+
 /** NOTE: in order to minimise side effects of functions, you manually have to call 
  *  buildUniformMap() and buildVertexAttributeMap() after you compiled, linked and enabled the shader.
  */
@@ -38,6 +57,11 @@ typedef list<ShaderPtr>                    ShaderList;
   static ShaderProgramPtr create() { return ShaderProgramPtr(new ShaderProgram); }
 
   Uniform& uniform(const string& inName);
+  Uniform& uniform(UniformHandle handle);
+  // resolves inName once so that frequently set uniforms can be accessed without string lookups.
+  // returns UniformHandleInvalid if there is no such uniform. Handles are invalidated by buildUniformMap().
+  UniformHandle uniformHandle(const string& inName);
+  Uniform* builtinUniform(BuiltinUniform bu) { return builtinUniforms[bu]; } // NULL if the shader doesn't use it
   Uniform& operator[](const string& inName);
   void attach(ShaderPtr& inShader);
   void detachAllShaders(); // detaches all shaders, throwing awa all internal references to shader objects
@@ -73,6 +97,9 @@ typedef list<ShaderPtr>                    ShaderList;
   UniformMap          name2uniform;
   VertexAttributeMap  name2vertexAttribute;
   ShaderList          shaders;
+  vector<Uniform*>    handle2uniform; // points into name2uniform, index is the UniformHandle
+  Uniform*            builtinUniforms[BuiltinUniformCount]; // points into name2uniform, NULL for unused ones
+  UniformStats        uniformStats; // issued and skipped uniform uploads, Uniforms keep a CPU side copy of their last value
 };
 
 }
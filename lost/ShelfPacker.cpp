@@ -0,0 +1,78 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "lost/ShelfPacker.h"
+
+namespace lost
+{
+
+ShelfPacker::ShelfPacker()
+{
+  reset(Vec2(0,0));
+}
+
+void ShelfPacker::reset(const Vec2& inSize, uint32_t inPadding)
+{
+  size = inSize;
+  padding = inPadding;
+  shelves.clear();
+  top = 0;
+}
+
+bool ShelfPacker::add(const Vec2& rectSize, Rect& outRect)
+{
+  uint32_t width = (uint32_t)rectSize.width + padding;
+  uint32_t height = (uint32_t)rectSize.height + padding;
+  uint32_t maxWidth = (uint32_t)size.width;
+  uint32_t maxHeight = (uint32_t)size.height;
+  
+  // use the existing shelf that wastes the least height
+  Shelf* best = NULL;
+  for(uint32_t i=0; i<shelves.size(); ++i)
+  {
+    Shelf& shelf = shelves[i];
+    if((shelf.height >= height) && (shelf.x + width <= maxWidth))
+    {
+      if(!best || (shelf.height < best->height))
+      {
+        best = &shelf;
+      }
+    }
+  }
+  
+  // or open a new one if there's still room below the last shelf
+  if(!best)
+  {
+    if((top + height > maxHeight) || (width > maxWidth))
+    {
+      return false;
+    }
+    Shelf shelf;
+    shelf.y = top;
+    shelf.height = height;
+    shelf.x = 0;
+    shelves.push_back(shelf);
+    top += height;
+    best = &shelves.back();
+  }
+  
+  outRect = Rect((float)best->x, (float)best->y, rectSize.width, rectSize.height);
+  best->x += width;
+  return true;
+}
+
+}
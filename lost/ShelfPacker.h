@@ -0,0 +1,56 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef LOST_SHELFPACKER_H
+#define LOST_SHELFPACKER_H
+
+namespace lost
+{
+
+/** Online rect packer that places rects one at a time on horizontal shelves.
+ *  Rects that were already placed never move, so the packer can be used for atlases that are filled incrementally.
+ *  Packing density is worse than RectPacker's, but is good enough for rects of similar height, like glyphs.
+ */
+struct ShelfPacker
+{
+  ShelfPacker();
+  
+  void reset(const Vec2& inSize, uint32_t inPadding = 1); // removes all rects. padding is the gap between neighbouring rects.
+  
+  /** finds a free area for a rect of the given size.
+   *  @return true if the rect fits, outRect then receives its position in the target area.
+   */
+  bool add(const Vec2& rectSize, Rect& outRect);
+  
+  Vec2 size; // size of the target area
+  uint32_t padding;
+  
+private:
+  struct Shelf
+  {
+    uint32_t y;
+    uint32_t height;
+    uint32_t x; // next free x position
+  };
+  
+  vector<Shelf> shelves;
+  uint32_t top; // y of the next new shelf
+};
+
+}
+
+#endif
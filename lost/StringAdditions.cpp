@@ -104,7 +104,7 @@ u32string convertUtf8ToUtf32(const string& utf8string)
 string convertUtf32ToUtf8String(const u32string& utf32string)
 {
   string result;
-  utf8::utf32to8(utf32string.begin(), utf32string.begin(), back_inserter(result));
+  utf8::utf32to8(utf32string.begin(), utf32string.end(), back_inserter(result));
   return result;
 }
 
@@ -17,29 +17,19 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lost/TextBuffer.h"
 #include "lost/Font.h"
 #include "lost/TextRender.h"
+#include "lost/TextMesh.h"
 #include "StringAdditions.h"
 
 namespace lost
 {
 
-uint32_t skipToNewlineOrEnd(uint32_t pos, const u32string& txt)
-{
-  if(pos < txt.size())
-  {
-    while((txt[pos] != '\n') && (pos < txt.size()))
-    {
-      ++pos;
-    }
-  }
-  return pos;
-}
-
-
 TextBuffer::TextBuffer()
 {
   _breakMode = BREAKMODE_NONE;
   _characterMetrics = false;
   _align = 0;
+  _lineBegin = 0;
+  _width = 0;
   _dirty = true;
 }
 
@@ -55,15 +45,13 @@ void TextBuffer::text(const string& inUtf8String)
   // normalise newlines into copy of text
   string normalised(inUtf8String); 
   normaliseNewlines(normalised);
-  _text.clear();
-  // transcode to utf32 for parsing
-  _text = convertUtf8ToUtf32(normalised);
+  _text.assign(normalised);
 }
 
 string TextBuffer::utf8String()
 {
   string result;
-  result = convertUtf32ToUtf8String(_text);  
+  result = _text.utf8String();
   return result;
 }
 
@@ -83,7 +71,7 @@ string TextBuffer::substring(uint32_t fromLine, uint32_t fromIndex, uint32_t toL
       t = _physicalLines[fromLine].begin + fromIndex;
     }
     if (f < _text.size() && t > 0 && t <= _text.size()) {
-      result = convertUtf32ToUtf8String(u32string(_text.begin()+f, _text.begin()+t));
+      result = _text.utf8Substring(f, t);
     }
   }
   return result;
@@ -118,27 +106,109 @@ void TextBuffer::reset()
   _logicalLines.clear(); // discard all previous lines
   _physicalLines.clear();
   
-  uint32_t pos = 0;
-  uint32_t nextPos = 0;
+  scanLogicalLines(0, (uint32_t)_text.size(), _logicalLines);
+  resetPhysicalLines();
+}
+
+void TextBuffer::scanLogicalLines(uint32_t from, uint32_t to, vector<LogicalLine>& outLines)
+{
+  uint32_t pos = from;
+  uint32_t nextPos = from;
   do {
     pos = nextPos;
-    nextPos = skipToNewlineOrEnd(pos, _text);
+    nextPos = _text.find('\n', pos);
     if(nextPos != pos)
     {
-      _logicalLines.push_back(LogicalLine(Range(pos, nextPos)));
+      outLines.push_back(LogicalLine(Range(pos, nextPos)));
       ++nextPos;
     }
     else {
       // must check for empty line
       if(nextPos < _text.size())
       {
-        _logicalLines.push_back(LogicalLine(Range(pos, pos)));
+        outLines.push_back(LogicalLine(Range(pos, pos)));
         ++nextPos;
       }
     }
-  } while (pos != nextPos);
+  } while ((pos != nextPos) && (nextPos <= to));
+}
+
+bool TextBuffer::logicalLineEndsBefore(const LogicalLine& line, uint32_t pos)
+{
+  return line.line.end < pos;
+}
+
+bool rangeBeginsBefore(const Range& r, uint32_t pos)
+{
+  return r.begin < pos;
+}
+
+bool beginsAfter(uint32_t pos, const Range& r)
+{
+  return pos < r.begin;
+}
+
+void TextBuffer::replaceText(uint32_t from, uint32_t to, const string& replacement)
+{
+  // logical lines containing the start and end of the edit
+  uint32_t firstLine = (uint32_t)(std::lower_bound(_logicalLines.begin(), _logicalLines.end(), from, logicalLineEndsBefore) - _logicalLines.begin());
+  uint32_t lastLine = (uint32_t)(std::lower_bound(_logicalLines.begin(), _logicalLines.end(), to, logicalLineEndsBefore) - _logicalLines.begin());
   
-  resetPhysicalLines();
+  if(_dirty || (lastLine >= _logicalLines.size()) || (_logicalLines[firstLine].line.begin > from))
+  {
+    // the edit isn't covered by the current lines, e.g. appending after a trailing newline
+    _text.erase(from, to);
+    _text.insert(from, replacement);
+    _dirty = true;
+    reset();
+    return;
+  }
+  
+  Range first = _logicalLines[firstLine].line;
+  Range last = _logicalLines[lastLine].line;
+  
+  // physical lines of the touched logical lines
+  uint32_t firstPhysical = (uint32_t)(std::lower_bound(_physicalLines.begin(), _physicalLines.end(), first.begin, rangeBeginsBefore) - _physicalLines.begin());
+  uint32_t endPhysical = (uint32_t)(std::upper_bound(_physicalLines.begin(), _physicalLines.end(), last.end, beginsAfter) - _physicalLines.begin());
+  
+  _text.erase(from, to);
+  int32_t delta = (int32_t)_text.insert(from, replacement) - (int32_t)(to-from);
+  
+  vector<LogicalLine> logicalLines;
+  scanLogicalLines(first.begin, last.end+delta, logicalLines);
+  vector<Range> physicalLines;
+  for(vector<LogicalLine>::iterator line=logicalLines.begin(); line!=logicalLines.end(); ++line)
+  {
+    breakLogicalLine(line->line, physicalLines);
+  }
+  
+  // lines after the edit keep their wrapping, they only move
+  for(vector<LogicalLine>::iterator line=_logicalLines.begin()+lastLine+1; line!=_logicalLines.end(); ++line)
+  {
+    line->line.begin += delta;
+    line->line.end += delta;
+  }
+  for(vector<Range>::iterator r=_physicalLines.begin()+endPhysical; r!=_physicalLines.end(); ++r)
+  {
+    r->begin += delta;
+    r->end += delta;
+  }
+  
+  _logicalLines.erase(_logicalLines.begin()+firstLine, _logicalLines.begin()+lastLine+1);
+  _logicalLines.insert(_logicalLines.begin()+firstLine, logicalLines.begin(), logicalLines.end());
+  _physicalLines.erase(_physicalLines.begin()+firstPhysical, _physicalLines.begin()+endPhysical);
+  _physicalLines.insert(_physicalLines.begin()+firstPhysical, physicalLines.begin(), physicalLines.end());
+  
+  // meshes of the re-wrapped lines are recycled, the meshes after them move with their lines
+  map<uint32_t, TextMeshPtr> lineMeshes;
+  int32_t lineDelta = (int32_t)physicalLines.size() - (int32_t)(endPhysical-firstPhysical);
+  for(map<uint32_t, TextMeshPtr>::iterator pos=_lineMeshes.begin(); pos!=_lineMeshes.end(); ++pos)
+  {
+    if(pos->first < firstPhysical) { lineMeshes[pos->first] = pos->second; }
+    else if(pos->first >= endPhysical) { lineMeshes[pos->first+lineDelta] = pos->second; }
+    else { _unusedLineMeshes.push_back(pos->second); }
+  }
+  _lineMeshes.swap(lineMeshes);
 }
 
 uint32_t TextBuffer::numLogicalLines()
@@ -165,53 +235,46 @@ void TextBuffer::normaliseNewlines(string& inText)
   replaceAll(inText, "\r", "\n");
 }
 
-void TextBuffer::breakModeNone()
+void TextBuffer::breakModeNone(const Range& lr, vector<Range>& outLines)
 {
-  for(vector<LogicalLine>::iterator pos=_logicalLines.begin(); pos!=_logicalLines.end(); ++pos)
-  {
-    _physicalLines.push_back(pos->line);
-  }
+  outLines.push_back(lr);
 }
 
-void TextBuffer::breakModeChar()
+void TextBuffer::breakModeChar(const Range& lr, vector<Range>& outLines)
 {
-  for(vector<LogicalLine>::iterator line=_logicalLines.begin(); line!=_logicalLines.end(); ++line)
+  if(lr.begin == lr.end) // skip empty lines
   {
-    Range& lr = line->line;
-    if(lr.begin == lr.end) // skip empty lines
-    {
-      _physicalLines.push_back(lr); // doesn't matter what we push here as long as begin == end
-      continue;
-    }
-    uint32_t prevChar = 0;
-    float sum = 0.0f;
-    Range curRange;
-    for(uint32_t i=lr.begin; i<lr.end; ++i)
+    outLines.push_back(lr); // doesn't matter what we push here as long as begin == end
+    return;
+  }
+  uint32_t prevChar = 0;
+  float sum = 0.0f;
+  Range curRange;
+  for(uint32_t i=lr.begin; i<lr.end; ++i)
+  {
+    uint32_t curChar = lineCharacter(i);
+    float adv = _font->characterAdvance(prevChar, curChar);
+    prevChar = curChar;
+    if((sum+adv)<_width)
     {
-      uint32_t curChar = _text[i];
-      float adv = _font->characterAdvance(prevChar, curChar);
-      prevChar = curChar;
-      if((sum+adv)<_width)
+      curRange.end++;
+      sum+=adv;
+      if(i == lr.end-1)
       {
-        curRange.end++;
-        sum+=adv;
-        if(i == lr.end-1)
-        {
-          _physicalLines.push_back(Range(lr.begin+curRange.begin, lr.begin+curRange.end));
-        }
+        outLines.push_back(Range(lr.begin+curRange.begin, lr.begin+curRange.end));
       }
-      else
+    }
+    else
+    {
+      outLines.push_back(Range(lr.begin+curRange.begin, lr.begin+curRange.end));
+      curRange.begin = curRange.end;
+      curRange.end++;
+      prevChar = 0;
+      sum = _font->characterAdvance(prevChar, curChar);
+      // if the trigger was the last character, we have to add it since the loop will now finish and it would be dropped
+      if(i == lr.end-1)
       {
-        _physicalLines.push_back(Range(lr.begin+curRange.begin, lr.begin+curRange.end));
-        curRange.begin = curRange.end;
-        curRange.end++;
-        prevChar = 0;
-        sum = _font->characterAdvance(prevChar, curChar);
-        // if the trigger was the last character, we have to add it since the loop will now finish and it would be dropped
-        if(i == lr.end-1)
-        {
-          _physicalLines.push_back(Range(lr.begin+curRange.begin, lr.begin+curRange.end));
-        }
+        outLines.push_back(Range(lr.begin+curRange.begin, lr.begin+curRange.end));
       }
     }
   }
@@ -236,9 +299,9 @@ bool isWhiteSpace(uint32_t c)
 TextBuffer::WordPos TextBuffer::skipToWordStart(const WordPos& fromHere, const Range& lineRange)
 {
   WordPos result = fromHere;
-  while(isWhiteSpace(_text[result.pos]) && (result.pos<lineRange.end))
+  while(isWhiteSpace(lineCharacter(result.pos)) && (result.pos<lineRange.end))
   {
-    result.size += _font->characterAdvance(result.prevchar, _text[result.pos]);
+    result.size += _font->characterAdvance(result.prevchar, lineCharacter(result.pos));
     ++result.pos;
   }
   return result;
@@ -247,9 +310,9 @@ TextBuffer::WordPos TextBuffer::skipToWordStart(const WordPos& fromHere, const R
 TextBuffer::WordPos TextBuffer::skipToWordEnd(const WordPos& fromHere, const Range& lineRange)
 {
   WordPos result = fromHere;
-  while(!isWhiteSpace(_text[result.pos]) && (result.pos<lineRange.end))
+  while(!isWhiteSpace(lineCharacter(result.pos)) && (result.pos<lineRange.end))
   {
-    result.size += _font->characterAdvance(result.prevchar, _text[result.pos]);
+    result.size += _font->characterAdvance(result.prevchar, lineCharacter(result.pos));
     ++result.pos;
   }
   return result;
@@ -281,57 +344,135 @@ bool terminalWord(const TextBuffer::Word& w, const Range& r)
   return ((w.start.pos == r.end) && (w.end.pos == r.end));
 }
 
-void TextBuffer::breakModeWord()
+void TextBuffer::breakModeWord(const Range& lr, vector<Range>& outLines)
 {
-  for(vector<LogicalLine>::iterator line=_logicalLines.begin(); line!=_logicalLines.end(); ++line)
+  if(lr.begin == lr.end) // skip empty lines
   {
-    Range& lr = line->line;
-    if(lr.begin == lr.end) // skip empty lines
+    outLines.push_back(lr); // doesn't matter what we push here as long as begin == end
+    return;
+  }
+  
+  uint32_t segmentstart = lr.begin;
+  Word prevword;
+  prevword.start.pos = lr.begin;
+  prevword.end.pos = lr.begin;
+  Word curword;
+  do {
+    curword = skipToNextWord(prevword, lr);
+    if((curword.size() > _width) || (terminalWord(curword, lr)))
     {
-      _physicalLines.push_back(lr); // doesn't matter what we push here as long as begin == end
-      continue;
+      outLines.push_back(Range(segmentstart, prevword.end.pos));
+      segmentstart = curword.start.pos;
+      curword.end.size -= curword.start.size; // reset size for further line measurement
+      curword.start.size = 0;
     }
-    
-    uint32_t segmentstart = lr.begin;
-    Word prevword;
-    prevword.start.pos = lr.begin;
-    prevword.end.pos = lr.begin;
-    Word curword;
-    do {
-      curword = skipToNextWord(prevword, lr);
-      if((curword.size() > _width) || (terminalWord(curword, lr)))
-      {
-        _physicalLines.push_back(Range(segmentstart, prevword.end.pos));
-        segmentstart = curword.start.pos;
-        curword.end.size -= curword.start.size; // reset size for further line measurement
-        curword.start.size = 0;
-      }
-      prevword = curword;
-    } while (!terminalWord(curword, lr));
-    
-  }
+    prevword = curword;
+  } while (!terminalWord(curword, lr));
+  
 }
 
-void TextBuffer::resetPhysicalLines()
+void TextBuffer::breakLogicalLine(const Range& lr, vector<Range>& outLines)
 {
-  _physicalLines.clear();
+  // only the line that is broken is decoded, the breakmodes access it with text positions through lineCharacter()
+  _lineText = _text.substring(lr.begin, lr.end);
+  _lineBegin = lr.begin;
   //  DOUT("using breakmode "<<_breakMode);
   switch(_breakMode)
   { 
-    case BREAKMODE_NONE:breakModeNone();break;
-    case BREAKMODE_CHAR:breakModeChar();break;
-    case BREAKMODE_WORD:breakModeWord();break;
+    case BREAKMODE_NONE:breakModeNone(lr, outLines);break;
+    case BREAKMODE_CHAR:breakModeChar(lr, outLines);break;
+    case BREAKMODE_WORD:breakModeWord(lr, outLines);break;
+  }
+}
+
+void TextBuffer::resetPhysicalLines()
+{
+  _physicalLines.clear();
+  for(vector<LogicalLine>::iterator line=_logicalLines.begin(); line!=_logicalLines.end(); ++line)
+  {
+    breakLogicalLine(line->line, _physicalLines);
   }
+  recycleLineMeshes();
 }
 
 void TextBuffer::renderPhysicalLine(uint32_t num, const TextMeshPtr& target)
 {
-  render(_text, _physicalLines[num], _font, target, _characterMetrics, _align);
+  const Range& r = _physicalLines[num];
+  u32string line = _text.substring(r.begin, r.end);
+  render(line, Range(0, (uint32_t)line.size()), _font, target, _characterMetrics, _align);
 }
 
 void TextBuffer::renderAllPhysicalLines(const TextMeshPtr& target)
 {
-  render(_text, _physicalLines, _font, target, _characterMetrics, _align);
+  render(_text.substring(0, _text.size()), _physicalLines, _font, target, _characterMetrics, _align);
+}
+
+const TextMeshPtr& TextBuffer::physicalLineMesh(uint32_t num)
+{
+  TextMeshPtr& result = _lineMeshes[num];
+  if(!result)
+  {
+    if(_unusedLineMeshes.size())
+    {
+      result = _unusedLineMeshes.back();
+      _unusedLineMeshes.pop_back();
+    }
+    else
+    {
+      result = TextMesh::create();
+    }
+    renderPhysicalLine(num, result);
+  }
+  return result;
+}
+
+void TextBuffer::renderVisiblePhysicalLines(float scrollOffset, float visibleHeight, vector<TextMeshPtr>& outMeshes)
+{
+  outMeshes.clear();
+  float lineHeight = floorf(_font->lineHeight);
+  if(lineHeight <= 0)
+  {
+    return;
+  }
+  
+  uint32_t first = (uint32_t)std::max(floorf(scrollOffset/lineHeight), 0.0f);
+  uint32_t end = (uint32_t)std::max(ceilf((scrollOffset+visibleHeight)/lineHeight), 0.0f);
+  end = std::min(end, numPhysicalLines());
+  
+  // lines that scrolled out of view give their meshes to the lines that scrolled in
+  for(map<uint32_t, TextMeshPtr>::iterator pos=_lineMeshes.begin(); pos!=_lineMeshes.end();)
+  {
+    if((pos->first < first) || (pos->first >= end))
+    {
+      _unusedLineMeshes.push_back(pos->second);
+      _lineMeshes.erase(pos++);
+    }
+    else
+    {
+      ++pos;
+    }
+  }
+  
+  for(uint32_t i=first; i<end; ++i)
+  {
+    const TextMeshPtr& mesh = physicalLineMesh(i);
+    float dx = 0;
+    if(_align == 1) { dx = floorf((_width - mesh->size.width)/2.0f); }
+    else if(_align == 2) { dx = _width - mesh->size.width; }
+    // the baseline is above the bottom of the line by the descender, like in renderAllPhysicalLines
+    float lineBottom = floorf(visibleHeight + scrollOffset) - (i+1)*lineHeight;
+    mesh->transform = Matrix::translate(std::max(dx, 0.0f), lineBottom - _font->descender);
+    outMeshes.push_back(mesh);
+  }
+}
+
+void TextBuffer::recycleLineMeshes()
+{
+  for(map<uint32_t, TextMeshPtr>::iterator pos=_lineMeshes.begin(); pos!=_lineMeshes.end(); ++pos)
+  {
+    _unusedLineMeshes.push_back(pos->second);
+  }
+  _lineMeshes.clear();
 }
 
 bool TextBuffer::getCharacterMetrics()
@@ -341,6 +482,10 @@ bool TextBuffer::getCharacterMetrics()
 
 void TextBuffer::setCharacterMetrics(bool v)
 {
+  if(_characterMetrics != v)
+  {
+    recycleLineMeshes();
+  }
   _characterMetrics = v;
 }
 
@@ -357,26 +502,17 @@ uint32_t TextBuffer::numCharsInPhysicalLine(uint32_t lineIndex)
 
 void TextBuffer::insertUtf8StringAtPosition(uint32_t lineIndex, uint32_t charIndex, const string& inString)
 {
-  u32string decoded = convertUtf8ToUtf32(inString);
+  string normalised(inString);
+  normaliseNewlines(normalised);
   
+  reset();
   Range r;
   if(lineIndex < _physicalLines.size())
   {
     r = _physicalLines[lineIndex];
   }
-  _text.insert(r.begin+charIndex, decoded);
-  if (_physicalLines.size() == 0 || inString.find("\r") != string::npos || inString.find("\n") != string::npos || inString.find("\r\n") != string::npos) {
-    _dirty = true;
-    reset();
-  }
-  else {
-    // update lines
-    _physicalLines[lineIndex].end += decoded.size();
-    for(vector<Range>::iterator r = _physicalLines.begin()+lineIndex+1; r != _physicalLines.end(); ++r) {
-      r->begin += decoded.size();
-      r->end += decoded.size();
-    }
-  }
+  uint32_t pos = std::min(r.begin+charIndex, (uint32_t)_text.size());
+  replaceText(pos, pos, normalised);
 }
 
 void TextBuffer::eraseCharAtPosition(uint32_t lineIndex, uint32_t charIndex)
@@ -386,25 +522,20 @@ void TextBuffer::eraseCharAtPosition(uint32_t lineIndex, uint32_t charIndex)
 
 void TextBuffer::eraseChars(uint32_t fromLine, uint32_t fromIndex, uint32_t toLine, uint32_t toIndex)
 {
+  reset();
   if (fromLine < _physicalLines.size() && toLine < _physicalLines.size())
   {
-    uint32_t f, t, d;
+    uint32_t f, t;
     if (fromLine < toLine || (fromLine == toLine && fromIndex < toIndex)) {
       f = _physicalLines[fromLine].begin + fromIndex;
       t = _physicalLines[toLine].begin + toIndex;
-      d = toLine - fromLine;
     }
     else {
       f = _physicalLines[toLine].begin + toIndex;
       t = _physicalLines[fromLine].begin + fromIndex;
-      d = fromLine - toLine;
     }
     if (f < _text.size() && t > 0 && t <= _text.size()) {
-      _text.erase(f, t-f);
-      if (d > 0) {
-        _dirty = true;
-        reset();
-      }
+      replaceText(f, t, string());
     }
   }
 }
@@ -416,6 +547,10 @@ int TextBuffer::getAlign()
 
 void TextBuffer::setAlign(int v)
 {
+  if(_align != v)
+  {
+    recycleLineMeshes();
+  }
   _align = v;
 }
 
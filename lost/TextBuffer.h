@@ -19,6 +19,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "lost/Range.h"
 #include "lost/TextBreakmodes.h"
+#include "lost/TextRope.h"
 
 namespace lost
 {
@@ -34,6 +35,7 @@ public:
   string utf8String(); // returns the current data as utf8 string
   string substring(uint32_t fromLine, uint32_t fromIndex, uint32_t toLine, uint32_t toIndex);
   void font(const FontPtr& inFont);
+  const FontPtr& font() { return _font; }
   void breakMode(BreakMode inBreakMode);
   void width(float inWidth);
   void reset();
@@ -57,6 +59,16 @@ public:
   void renderPhysicalLine(uint32_t num, const TextMeshPtr& target);
   void renderAllPhysicalLines(const TextMeshPtr& target);
   
+  // returns a mesh of a single physical line. It is only rendered again if an edit changed the line, lines that only moved keep their mesh.
+  const TextMeshPtr& physicalLineMesh(uint32_t num);
+  
+  /** renders only the physical lines that are visible when the text is scrolled down by scrollOffset pixels.
+   *  The meshes are positioned in a visibleHeight high area with the origin at the bottom left, lines at the edges overlap it.
+   *  Meshes of lines that scrolled out of view are reused, so the number of meshes only depends on visibleHeight.
+   */
+  void renderVisiblePhysicalLines(float scrollOffset, float visibleHeight, vector<TextMeshPtr>& outMeshes);
+  
+  // edits only re-wrap the logical lines they touch, the lines after them are moved
   void insertUtf8StringAtPosition(uint32_t lineIndex, uint32_t charIndex, const string& inString);
   void eraseCharAtPosition(uint32_t lineIndex, uint32_t charIndex);
   void eraseChars(uint32_t fromLine, uint32_t fromIndex, uint32_t toLine, uint32_t toIndex);
@@ -87,11 +99,15 @@ private:
     Range line;
   };
   
-  vector<LogicalLine>  _logicalLines;
+  vector<LogicalLine>  _logicalLines; // also serve as line start index into _text
   vector<Range>        _physicalLines;
+  map<uint32_t, TextMeshPtr> _lineMeshes; // meshes of rendered physical lines, by line index
+  vector<TextMeshPtr>  _unusedLineMeshes; // recycled for lines that weren't rendered yet
   FontPtr                   _font;
   BreakMode                 _breakMode;
-  u32string               _text;
+  TextRope                  _text;
+  u32string                 _lineText; // decoded logical line that is currently being broken
+  uint32_t                  _lineBegin; // text position of _lineText
   float                     _width;
   bool                      _characterMetrics;
   int                       _align;
@@ -100,9 +116,16 @@ private:
   void resetPhysicalLines();
   void normaliseNewlines(string& inText);
   
-  void breakModeNone();
-  void breakModeChar();
-  void breakModeWord();
+  void scanLogicalLines(uint32_t from, uint32_t to, vector<LogicalLine>& outLines); // finds the logical lines starting at from, up to the line that ends at to
+  static bool logicalLineEndsBefore(const LogicalLine& line, uint32_t pos);
+  void replaceText(uint32_t from, uint32_t to, const string& replacement); // replaces the text and re-wraps the logical lines it touched
+  
+  void recycleLineMeshes();
+  void breakLogicalLine(const Range& lr, vector<Range>& outLines);
+  char32_t lineCharacter(uint32_t pos) { return _lineText[pos-_lineBegin]; } // pos may be the end of the line
+  void breakModeNone(const Range& lr, vector<Range>& outLines);
+  void breakModeChar(const Range& lr, vector<Range>& outLines);
+  void breakModeWord(const Range& lr, vector<Range>& outLines);
   
   
   WordPos skipToWordStart(const WordPos& fromHere, const Range& lineRange);
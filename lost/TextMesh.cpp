@@ -43,6 +43,7 @@ MeshPtr TextMesh::clone()
   result->transform = transform;
   result->vertexBuffer = vertexBuffer;
   result->indexBuffer = indexBuffer;
+  result->indexCount = indexCount;
   result->min = min;
   result->max = max;
   result->size = size;
@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "lost/TextMeshCache.h"
+#include "lost/StringAdditions.h"
+
+namespace lost
+{
+
+TextMeshCache::Key::Key(const string& inText, const FontPtr& inFont, float inWidth, BreakMode inBreakMode, int inAlignment)
+: text(inText), font(inFont), width(inWidth), breakMode(inBreakMode), alignment(inAlignment)
+{
+  hash = djb2Hash(text.c_str());
+}
+
+bool TextMeshCache::Key::operator<(const Key& other) const
+{
+  if(hash != other.hash) { return hash < other.hash; }
+  if(font != other.font) { return font < other.font; }
+  if(width != other.width) { return width < other.width; }
+  if(breakMode != other.breakMode) { return breakMode < other.breakMode; }
+  if(alignment != other.alignment) { return alignment < other.alignment; }
+  return text < other.text;
+}
+
+TextMeshCache::TextMeshCache(uint32_t inCapacity)
+{
+  capacity = inCapacity;
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+}
+
+TextMeshPtr TextMeshCache::mesh(const Key& key)
+{
+  TextMeshPtr result;
+  
+  map<Key, EntryList::iterator>::iterator pos = _lookup.find(key);
+  if(pos != _lookup.end())
+  {
+    _entries.splice(_entries.begin(), _entries, pos->second);
+    result = pos->second->second;
+    ++hits;
+  }
+  else
+  {
+    ++misses;
+  }
+  
+  return result;
+}
+
+void TextMeshCache::mesh(const Key& key, const TextMeshPtr& mesh)
+{
+  map<Key, EntryList::iterator>::iterator pos = _lookup.find(key);
+  if(pos != _lookup.end())
+  {
+    pos->second->second = mesh;
+    _entries.splice(_entries.begin(), _entries, pos->second);
+    return;
+  }
+  
+  while(_entries.size() && (_entries.size() >= capacity))
+  {
+    _lookup.erase(_entries.back().first);
+    _entries.pop_back();
+    ++evictions;
+  }
+  
+  _entries.push_front(make_pair(key, mesh));
+  _lookup[key] = _entries.begin();
+}
+
+void TextMeshCache::clear()
+{
+  _lookup.clear();
+  _entries.clear();
+}
+
+void TextMeshCache::logStats()
+{
+  DOUT("text meshes cached: "<<size()<<"/"<<capacity<<" hits: "<<hits<<" misses: "<<misses<<" evictions: "<<evictions);
+}
+
+}
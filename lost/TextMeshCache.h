@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef LOST_TEXTMESHCACHE_H
+#define LOST_TEXTMESHCACHE_H
+
+namespace lost
+{
+
+/** Keeps the meshes of recently laid out strings around, so unchanged text doesn't have to be converted,
+ *  broken into lines and rendered again every time it's drawn.
+ *  Meshes stay valid until they're evicted, since glyphs never move in their atlas.
+ *  The least recently used mesh is evicted when the cache is full.
+ */
+struct TextMeshCache
+{
+  // describes one laid out string. width is the wrapping width, or < 0 for single line text.
+  struct Key
+  {
+    Key(const string& inText, const FontPtr& inFont, float inWidth, BreakMode inBreakMode, int inAlignment);
+    bool operator<(const Key& other) const;
+    
+    u32       hash; // compared before the text, which is only needed on collisions
+    string    text;
+    FontPtr   font; // keeps the font alive as long as meshes are cached for it
+    float     width;
+    BreakMode breakMode;
+    int       alignment;
+  };
+  
+  TextMeshCache(uint32_t inCapacity = 256);
+  
+  TextMeshPtr mesh(const Key& key); // returns the cached mesh for key and marks it as recently used, or NULL if it wasn't cached
+  void mesh(const Key& key, const TextMeshPtr& mesh); // adds mesh for key, evicting the least recently used mesh if the cache is full
+  
+  void clear();
+  uint32_t size() { return (uint32_t)_entries.size(); }
+  void logStats();
+  
+  uint32_t capacity;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  
+private:
+  typedef list<pair<Key, TextMeshPtr> > EntryList; // most recently used first
+  
+  EntryList                         _entries;
+  map<Key, EntryList::iterator>     _lookup;
+};
+
+}
+
+#endif
@@ -18,6 +18,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lost/TextMesh.h"
 #include "lost/Font.h"
 #include "lost/Glyph.h"
+#include "lost/GlyphAtlas.h"
 #include "StringAdditions.h"
 
 namespace lost
@@ -31,9 +32,7 @@ void addGlyph(vector<Rect>& characterRects,
               Vec2& pmin,
               Vec2& pmax)
 {
-  Rect tr = glyph->rect;
-  tr.x = xoffset+glyph->xoffset;
-  tr.y = yoffset+glyph->yoffset;
+  Rect tr(xoffset+glyph->xoffset, yoffset+glyph->yoffset, glyph->size.width, glyph->size.height);
   
   characterRects.push_back(tr);
   pixelCoordRects.push_back(glyph->rect);
@@ -46,6 +45,43 @@ void addGlyph(vector<Rect>& characterRects,
 }
 
 
+// a mesh only has one texture, so all glyphs of the text have to be on the same atlas page.
+// glyphs from earlier pages are added again to the current one, which only happens if the text spans a page switch.
+// returns the page the text has to be drawn from.
+uint32_t gatherGlyphs(const u32string& inText, const vector<Range>& lines, const FontPtr& font)
+{
+  uint32_t minPage = font->atlas->currentPage();
+  for(vector<Range>::const_iterator pos=lines.begin(); pos!=lines.end(); ++pos)
+  {
+    for(uint32_t i=pos->begin; i<pos->end; ++i)
+    {
+      GlyphPtr glyph = font->glyph(inText[i]);
+      if(glyph && glyph->drawable)
+      {
+        minPage = std::min(minPage, glyph->page);
+      }
+    }
+  }
+  
+  uint32_t page = font->atlas->currentPage();
+  if(minPage != page)
+  {
+    for(vector<Range>::const_iterator pos=lines.begin(); pos!=lines.end(); ++pos)
+    {
+      for(uint32_t i=pos->begin; i<pos->end; ++i)
+      {
+        font->moveToCurrentPage(inText[i]);
+      }
+    }
+    if(font->atlas->currentPage() != page)
+    {
+      WOUT("text doesn't fit on a single glyph atlas page, some characters won't be drawn");
+      page = font->atlas->currentPage();
+    }
+  }
+  return page;
+}
+
 TextMeshPtr render(const string & inText, const FontPtr& font, bool characterMetrics, int align)
 {
   TextMeshPtr result(new TextMesh);
@@ -92,6 +128,7 @@ void render(const u32string& inText, const vector<Range>& lines, const FontPtr&
   uint32_t addIndex=0; // we iterate over all chracters, but not all of them might be drawable
   // so we need a separate index for the actual insertion of a character into the mesh
   
+  uint32_t page = gatherGlyphs(inText, lines, font);
   uint32_t previousGlyphIndex = 0;
   float xoffset = 0;    
   float yoffset = std::max((float)lines.size()-1, 0.0f)*floorf(font->lineHeight);
@@ -108,7 +145,7 @@ void render(const u32string& inText, const vector<Range>& lines, const FontPtr&
         xoffset+=font->kerningOffset(previousGlyphIndex, c);
         GlyphPtr glyph = font->glyph(c);
         if (!glyph) continue;
-        if (glyph->drawable)
+        if (glyph->drawable && (glyph->page == page))
         {
           addGlyph(characterRects, pixelCoordRects, glyph, xoffset, yoffset, pmin, pmax);
           if(characterMetrics) {target->pushCharacterRect(characterRects[addIndex]);}
@@ -147,7 +184,7 @@ void render(const u32string& inText, const vector<Range>& lines, const FontPtr&
     }
   }
   
-  target->init(characterRects, font->atlas, pixelCoordRects, false);
+  target->init(characterRects, font->atlas->texture(page), pixelCoordRects, false);
   target->min = pmin;
   target->max = pmax;
   target->size.width = (pmax.x-pmin.x)+1;  
@@ -0,0 +1,313 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "lost/TextRope.h"
+#include "thirdparty/utf8.h"
+
+namespace lost
+{
+
+static bool isContinuationByte(char c)
+{
+  return (c & 0xC0) == 0x80;
+}
+
+static uint32_t countCharacters(const string& data, size_t from, size_t to)
+{
+  uint32_t result = 0;
+  for(size_t i=from; i<to; ++i)
+  {
+    if(!isContinuationByte(data[i])) { ++result; }
+  }
+  return result;
+}
+
+// byte offset of the character with index pos in data
+static size_t byteOffset(const string& data, uint32_t pos)
+{
+  size_t result = 0;
+  while(result < data.size())
+  {
+    if(!isContinuationByte(data[result]))
+    {
+      if(pos == 0) { break; }
+      --pos;
+    }
+    ++result;
+  }
+  return result;
+}
+
+// chunks are decoded without checks, so invalid or truncated sequences are replaced with U+FFFD on the way in.
+// otherwise a truncated sequence at the end of a chunk would make the decoder read past it
+static string validUtf8(const string& utf8String)
+{
+  if(utf8::is_valid(utf8String.begin(), utf8String.end()))
+  {
+    return utf8String;
+  }
+  WOUT("replacing invalid UTF-8 sequences");
+  // not utf8::replace_invalid, this version of it throws on a sequence that is truncated by the end of the string
+  string result;
+  string::const_iterator i = utf8String.begin();
+  while(i != utf8String.end())
+  {
+    string::const_iterator sequence = i;
+    if(utf8::internal::validate_next(i, utf8String.end()) == utf8::internal::UTF8_OK)
+    {
+      result.append(sequence, i);
+    }
+    else
+    {
+      utf8::append(0xFFFD, back_inserter(result));
+      i = sequence+1;
+      while((i != utf8String.end()) && isContinuationByte(*i))
+      {
+        ++i;
+      }
+    }
+  }
+  return result;
+}
+
+TextRope::TextRope()
+{
+  _size = 0;
+}
+
+void TextRope::assign(const string& utf8String)
+{
+  _chunks.clear();
+  _size = 0;
+  if(utf8String.size())
+  {
+    _chunks.push_back(Chunk());
+    _chunks.back().data = validUtf8(utf8String);
+    _chunks.back().size = countCharacters(_chunks.back().data, 0, _chunks.back().data.size());
+    _size = _chunks.back().size;
+    splitChunk(0);
+  }
+  updateChunkStarts(0);
+}
+
+uint32_t TextRope::insert(uint32_t pos, const string& utf8String)
+{
+  if(utf8String.empty())
+  {
+    return 0;
+  }
+  if(_chunks.empty())
+  {
+    assign(utf8String);
+    return _size;
+  }
+  
+  const string text = validUtf8(utf8String);
+  uint32_t result = countCharacters(text, 0, text.size());
+  uint32_t c = chunkAt(pos);
+  Chunk& chunk = _chunks[c];
+  chunk.data.insert(byteOffset(chunk.data, pos - _chunkStarts[c]), text);
+  chunk.size += result;
+  _size += result;
+  if(chunk.data.size() > maxChunkSize)
+  {
+    splitChunk(c);
+  }
+  updateChunkStarts(c);
+  return result;
+}
+
+void TextRope::erase(uint32_t from, uint32_t to)
+{
+  to = std::min(to, _size);
+  if(from >= to)
+  {
+    return;
+  }
+  
+  uint32_t first = chunkAt(from);
+  uint32_t last = chunkAt(to-1);
+  if(first == last)
+  {
+    Chunk& chunk = _chunks[first];
+    size_t f = byteOffset(chunk.data, from - _chunkStarts[first]);
+    size_t t = byteOffset(chunk.data, to - _chunkStarts[first]);
+    chunk.data.erase(f, t-f);
+    chunk.size -= to-from;
+  }
+  else
+  {
+    Chunk& head = _chunks[first];
+    head.data.erase(byteOffset(head.data, from - _chunkStarts[first]));
+    head.size = from - _chunkStarts[first];
+    Chunk& tail = _chunks[last];
+    uint32_t erasedTail = to - _chunkStarts[last];
+    tail.data.erase(0, byteOffset(tail.data, erasedTail));
+    tail.size -= erasedTail;
+    _chunks.erase(_chunks.begin()+first+1, _chunks.begin()+last);
+  }
+  _size -= to-from;
+  
+  // don't keep empty chunks around, and keep small ones from piling up
+  for(uint32_t c=first+2; c-- > first;)
+  {
+    if((c < _chunks.size()) && _chunks[c].data.empty())
+    {
+      _chunks.erase(_chunks.begin()+c);
+    }
+  }
+  if(first < _chunks.size())
+  {
+    mergeChunk(first);
+  }
+  if(first > 0)
+  {
+    mergeChunk(first-1);
+  }
+  updateChunkStarts(first > 0 ? first-1 : 0);
+}
+
+uint32_t TextRope::find(char c, uint32_t from) const
+{
+  if(from >= _size)
+  {
+    return _size;
+  }
+  
+  uint32_t pos = from;
+  uint32_t chunk = chunkAt(from);
+  size_t i = byteOffset(_chunks[chunk].data, from - _chunkStarts[chunk]);
+  for(; chunk<_chunks.size(); ++chunk, i=0)
+  {
+    const string& data = _chunks[chunk].data;
+    for(; i<data.size(); ++i)
+    {
+      if(!isContinuationByte(data[i]))
+      {
+        if(data[i] == c) { return pos; }
+        ++pos;
+      }
+    }
+  }
+  return _size;
+}
+
+u32string TextRope::substring(uint32_t from, uint32_t to) const
+{
+  u32string result;
+  to = std::min(to, _size);
+  if(from >= to)
+  {
+    return result;
+  }
+  
+  result.reserve(to-from);
+  uint32_t chunk = chunkAt(from);
+  string::const_iterator i = _chunks[chunk].data.begin() + byteOffset(_chunks[chunk].data, from - _chunkStarts[chunk]);
+  while(result.size() < to-from)
+  {
+    if(i == _chunks[chunk].data.end())
+    {
+      ++chunk;
+      i = _chunks[chunk].data.begin();
+    }
+    result.push_back(utf8::unchecked::next(i)); // safe, chunks only hold valid UTF-8 and are split between sequences
+  }
+  return result;
+}
+
+string TextRope::utf8Substring(uint32_t from, uint32_t to) const
+{
+  string result;
+  to = std::min(to, _size);
+  if(from >= to)
+  {
+    return result;
+  }
+  
+  uint32_t first = chunkAt(from);
+  uint32_t last = chunkAt(to-1);
+  for(uint32_t chunk=first; chunk<=last; ++chunk)
+  {
+    const string& data = _chunks[chunk].data;
+    size_t f = (chunk == first) ? byteOffset(data, from - _chunkStarts[chunk]) : 0;
+    size_t t = (chunk == last) ? byteOffset(data, to - _chunkStarts[chunk]) : data.size();
+    result.append(data, f, t-f);
+  }
+  return result;
+}
+
+string TextRope::utf8String() const
+{
+  string result;
+  for(vector<Chunk>::const_iterator chunk=_chunks.begin(); chunk!=_chunks.end(); ++chunk)
+  {
+    result.append(chunk->data);
+  }
+  return result;
+}
+
+uint32_t TextRope::chunkAt(uint32_t pos) const
+{
+  uint32_t result = (uint32_t)(std::upper_bound(_chunkStarts.begin(), _chunkStarts.end(), pos) - _chunkStarts.begin());
+  return result > 0 ? result-1 : 0;
+}
+
+void TextRope::updateChunkStarts(uint32_t fromChunk)
+{
+  _chunkStarts.resize(_chunks.size());
+  uint32_t pos = (fromChunk > 0) ? _chunkStarts[fromChunk-1]+_chunks[fromChunk-1].size : 0;
+  for(uint32_t c=fromChunk; c<_chunks.size(); ++c)
+  {
+    _chunkStarts[c] = pos;
+    pos += _chunks[c].size;
+  }
+}
+
+void TextRope::splitChunk(uint32_t chunk)
+{
+  // split into half full chunks so following inserts don't have to split again right away
+  const string data = _chunks[chunk].data;
+  vector<Chunk> pieces;
+  size_t begin = 0;
+  while(begin < data.size())
+  {
+    size_t end = std::min(begin+maxChunkSize/2, data.size());
+    while((end < data.size()) && isContinuationByte(data[end]))
+    {
+      ++end;
+    }
+    pieces.push_back(Chunk());
+    pieces.back().data.assign(data, begin, end-begin);
+    pieces.back().size = countCharacters(data, begin, end);
+    begin = end;
+  }
+  _chunks.erase(_chunks.begin()+chunk);
+  _chunks.insert(_chunks.begin()+chunk, pieces.begin(), pieces.end());
+}
+
+void TextRope::mergeChunk(uint32_t chunk)
+{
+  if((chunk+1 < _chunks.size()) && (_chunks[chunk].data.size()+_chunks[chunk+1].data.size() <= maxChunkSize/2))
+  {
+    _chunks[chunk].data.append(_chunks[chunk+1].data);
+    _chunks[chunk].size += _chunks[chunk+1].size;
+    _chunks.erase(_chunks.begin()+chunk+1);
+  }
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef LOST_TEXTROPE_H
+#define LOST_TEXTROPE_H
+
+namespace lost
+{
+
+/** Stores text as UTF-8 in chunks of limited size, so edits only copy the chunk they touch.
+ *  Positions are character indices, like in a u32string. Finding the chunk of a position is a binary search,
+ *  the position inside the chunk is found by skipping UTF-8 sequences.
+ *  Invalid UTF-8 passed to assign() or insert() is replaced with U+FFFD.
+ */
+struct TextRope
+{
+  TextRope();
+  
+  void assign(const string& utf8String);
+  uint32_t insert(uint32_t pos, const string& utf8String); // returns the number of inserted characters
+  void erase(uint32_t from, uint32_t to);
+  
+  uint32_t size() const { return _size; } // number of characters
+  uint32_t find(char c, uint32_t from) const; // returns the position of the next ASCII character c at or after from, or size() if there is none
+  
+  u32string substring(uint32_t from, uint32_t to) const;
+  string utf8Substring(uint32_t from, uint32_t to) const;
+  string utf8String() const;
+  
+  static const uint32_t maxChunkSize = 2048; // in bytes
+  
+private:
+  struct Chunk
+  {
+    string    data;
+    uint32_t  size; // number of characters in data
+  };
+  
+  vector<Chunk>     _chunks;
+  vector<uint32_t>  _chunkStarts; // position of the first character of each chunk
+  uint32_t          _size;
+  
+  uint32_t chunkAt(uint32_t pos) const; // index of the chunk that contains pos, the last chunk for size()
+  void updateChunkStarts(uint32_t fromChunk);
+  void splitChunk(uint32_t chunk);
+  void mergeChunk(uint32_t chunk); // merges a small chunk with its successor
+};
+
+}
+
+#endif
@@ -55,7 +55,10 @@ Texture::Texture(const BitmapPtr& inBitmap, const Params& inParams)
 
 Texture::~Texture()
 {
-  Context::instance()->textureDying(this);
+  if(Context::instance()) // NULL after shutdown
+  {
+    Context::instance()->textureDying(this);
+  }
   destroy();
 }
 
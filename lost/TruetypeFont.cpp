@@ -17,8 +17,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "stb_truetype.h"
 #include "lost/TruetypeFont.h"
 
-#include "lost/BitmapPacker.h"
-#include "lost/Texture.h"
+#include "lost/GlyphAtlas.h"
 #include "lost/Bitmap.h"
 #include "lost/Glyph.h"
 #include "lost/Data.h"
@@ -27,7 +26,9 @@ namespace lost
 {
 
 TruetypeFont::TruetypeFont(const DataPtr& inData,
-                           uint32_t inSizeInPoints)
+                           uint32_t inSizeInPoints,
+                           const GlyphAtlasPtr& inAtlas,
+                           bool inSignedDistanceField)
 {
   const unsigned char* data = reinterpret_cast<unsigned char*>(inData->bytes.get());
   _fontinfo = (stbtt_fontinfo*)malloc(sizeof(stbtt_fontinfo));
@@ -35,10 +36,13 @@ TruetypeFont::TruetypeFont(const DataPtr& inData,
   _data = inData;
   ASSERT(stbtt_InitFont(_fontinfo, data, 0), "font init failed")
   size = inSizeInPoints;
-  atlasSize.width = 256;
-  atlasSize.height = 256;
+  signedDistanceField = inSignedDistanceField;
+  atlas = inAtlas ? inAtlas : GlyphAtlas::create(Vec2(512, 512), GL_ALPHA, signedDistanceField ? GL_LINEAR : GL_NEAREST);
 
   _vscale = stbtt_ScaleForPixelHeight(_fontinfo, size);
+  _sdfScale = stbtt_ScaleForPixelHeight(_fontinfo, sdfSize);
+  // a screen pixel covers sdfSize/size distance field pixels, and the distance changes by 1/(2*sdfSpread) per distance field pixel
+  sdfSmoothing = signedDistanceField ? .5f*sdfSize/(2.0f*sdfSpread*size) : 0;
   
   int ascent = 0;
   int descent = 0;
@@ -49,7 +53,6 @@ TruetypeFont::TruetypeFont(const DataPtr& inData,
   descender = floorf(descent*_vscale);
   lineHeight = floorf((ascent - descent + lineGap)*_vscale);
 //  DOUT("font ascender:"<<ascender<<" descender:"<<descender<<" lineHeight:"<<lineHeight);
-  rebuildTextureAtlas(); 
 }
 
 TruetypeFont::~TruetypeFont()
@@ -67,86 +70,104 @@ bool TruetypeFont::renderGlyph(char32_t c)
     glyph.reset(new Glyph);
 //    glyph->render(face, size, c);
     
-    int advance, lsb;
-    stbtt_GetCodepointHMetrics(_fontinfo, c, &advance, &lsb);
+    int advanceWidth, lsb;
+    stbtt_GetCodepointHMetrics(_fontinfo, c, &advanceWidth, &lsb);
     
+    float rasterScale = signedDistanceField ? _sdfScale : _vscale;
     int ix0, iy0, ix1, iy1;
-    stbtt_GetCodepointBitmapBox(_fontinfo, c, _vscale, _vscale, &ix0, &iy0, &ix1, &iy1);
+    stbtt_GetCodepointBitmapBox(_fontinfo, c, rasterScale, rasterScale, &ix0, &iy0, &ix1, &iy1);
     int width = ix1-ix0;
     int height = iy1-iy0;
-    unsigned char* bmpmem = (unsigned char*)malloc(width*height);
-    stbtt_MakeCodepointBitmapSubpixel(_fontinfo, bmpmem, width, height, width, _vscale, _vscale, .0, .0, c);
     
-    BitmapPtr result(new Bitmap(width,
-                                height,
-                                GL_RGBA,
-                                GL_ALPHA,
-                                bmpmem));  
-    result->flip();
-    free(bmpmem);
-    glyph->bitmap = result;
-    glyph->advance = floorf(advance*_vscale);
-    glyph->xoffset = floorf(lsb*_vscale);
-    glyph->yoffset = -iy1;
+    glyph->advance = this->advance(c);
+    if(signedDistanceField)
+    {
+      float k = _vscale/_sdfScale;
+      int border = sdfSpread;
+      glyph->xoffset = floorf((ix0-border)*k);
+      glyph->yoffset = floorf(-(iy1+border)*k);
+      glyph->size = Vec2((width+2*border)*k, (height+2*border)*k);
+    }
+    else
+    {
+      glyph->xoffset = floorf(lsb*_vscale);
+      glyph->yoffset = -iy1;
+      glyph->size = Vec2((float)width, (float)height);
+    }
+    // spaces might be rendered as 0/0 bitmaps, but have a valid advance value
+    // that we need to render the string correctly.
+    glyph->drawable = (width > 0) && (height > 0);
     
     char2glyph[c] = glyph;
-    glyphs.push_back(glyph);
   }
   return result;
 }
 
-void TruetypeFont::rebuildTextureAtlas()
+BitmapPtr TruetypeFont::renderBitmap(char32_t c)
 {
-  BitmapPacker::Result  packerResult;
+  float rasterScale = signedDistanceField ? _sdfScale : _vscale;
+  int ix0, iy0, ix1, iy1;
+  stbtt_GetCodepointBitmapBox(_fontinfo, c, rasterScale, rasterScale, &ix0, &iy0, &ix1, &iy1);
+  int width = ix1-ix0;
+  int height = iy1-iy0;
+  int border = signedDistanceField ? sdfSpread : 0; // distance fields fall off outside the glyph
+  int bmpWidth = width+2*border;
+  int bmpHeight = height+2*border;
+  unsigned char* bmpmem = (unsigned char*)calloc(bmpWidth*bmpHeight, 1);
+  stbtt_MakeCodepointBitmapSubpixel(_fontinfo, bmpmem+border*bmpWidth+border, width, height, bmpWidth, rasterScale, rasterScale, .0, .0, c);
   
-  vector<BitmapPtr> characterBitmaps;
-  vector<uint32_t> glyphIndex; // because we might not use all bitmaps, need to preserve the original indices of the glyphs
-  vector<GlyphPtr>::iterator i;
-  uint32_t counter = 0;
-  for(i=glyphs.begin(); i!=glyphs.end(); ++i)
+  BitmapPtr result(new Bitmap(bmpWidth,
+                              bmpHeight,
+                              GL_ALPHA,
+                              GL_ALPHA,
+                              bmpmem));
+  free(bmpmem);
+  if(signedDistanceField)
   {
-    // only use bitmaps that have width and height != 0
-    // spaces might be rendered as 0/0 bitmaps, but have a valid advance value
-    // that we need to render the string correctly.
-    BitmapPtr bmp = (*i)->bitmap;
-    if((bmp->width != 0) && (bmp->height != 0))
-    {
-      characterBitmaps.push_back(bmp);
-      glyphIndex.push_back(counter);
-    }
-    counter++;
+    result->signedDistanceField(sdfSpread);
+  }
+  if(atlas->format != GL_ALPHA)
+  {
+    result.reset(new Bitmap(bmpWidth, bmpHeight, atlas->format, GL_ALPHA, result->data));
+  }
+  result->flip();
+  return result;
+}
+
+void TruetypeFont::addToAtlas(const GlyphPtr& glyph, char32_t c, uint32_t minPage)
+{
+  if(!glyph->drawable)
+  {
+    return;
   }
   
-  BitmapPacker bitmapPacker;
-  bitmapPacker.pack(packerResult,
-                    atlasSize,
-                    characterBitmaps,
-                    GL_RGBA, // bitmaps rendered byte the renderGlyphToBitmap method are always RGBA
-                    false, // don't rotate rectbecause we don't support it yet
-                    false); // don't sort because we don't want to alter position of previously rendered glyphs in texture
-  
-  ASSERT(packerResult.rects.size() == characterBitmaps.size(), "couldn't pack all bitmaps in characterAtlas");
-  
-  // recreate atlas texture from current packed bitmap
-  // glyphs that were rendered in a previous pass should end up in the same spot in the atlas since we forced the packer to omit sorting
-  if(!atlas)
+  // distance fields don't depend on the font size, so all sizes of a face share them
+  const GlyphAtlas::SharedGlyph* shared = signedDistanceField ? atlas->sharedGlyph(_data.get(), c) : NULL;
+  if(shared && (shared->page >= minPage))
   {
-    //    DOUT("--- CREATING FONT ATLAS");
-    atlas.reset(new Texture(packerResult.packedBitmap));
+    glyph->page = shared->page;
+    glyph->rect = shared->rect;
+  }
+  else if(atlas->add(glyph, renderBitmap(c)))
+  {
+    if(signedDistanceField)
+    {
+      atlas->shareGlyph(_data.get(), c, glyph);
+    }
   }
   else
   {
-    //    DOUT("reinitialising bitmap");
-    atlas->bind();
-    atlas->init(packerResult.packedBitmap);
+    glyph->drawable = false;
   }
-  
-  // tell the glyphs where they are in the atlas texture in tex coords
-  // the rects are reordered in the result, but the bitmapids are preserved in the vector of the same name
-  for(uint32_t j=0; j<packerResult.rects.size(); ++j)
+}
+
+void TruetypeFont::moveToCurrentPage(uint32_t utf32character)
+{
+  GlyphPtr glyph = char2glyph[utf32character];
+  if(glyph && glyph->drawable && (glyph->page != atlas->currentPage()))
   {
-    glyphs[glyphIndex[packerResult.bitmapIds[j]]]->rect = packerResult.rects[j];
-  }  
+    addToAtlas(glyph, utf32character, atlas->currentPage());
+  }
 }
 
 GlyphPtr TruetypeFont::glyph(uint32_t utf32character)
@@ -156,17 +177,8 @@ GlyphPtr TruetypeFont::glyph(uint32_t utf32character)
   {
     if(this->renderGlyph(utf32character))
     {
-      rebuildTextureAtlas();
-    }
-    result = char2glyph[utf32character];
-    if(result && result->bitmap && (result->bitmap->width > 0) && (result->bitmap->height > 0))
-    {
-      result->drawable = true;
-    }
-    else
-    {
-      if(result)
-        result->drawable = false;
+      result = char2glyph[utf32character];
+      addToAtlas(result, utf32character);
     }
   }
   return result;
@@ -187,15 +199,28 @@ bool TruetypeFont::hasKerning()
   return _fontinfo->kern;
 }
 
-float TruetypeFont::characterAdvance(uint32_t previousChar, uint32_t currentChar)
+float TruetypeFont::advance(char32_t c)
 {
   float result = 0.0f;
-  GlyphPtr g = this->glyph(currentChar);
-  if(g)
+  std::map<char32_t, float>::iterator pos = char2advance.find(c);
+  if(pos != char2advance.end())
   {
-    result = g->advance + kerningOffset(previousChar, currentChar);
+    result = pos->second;
+  }
+  else
+  {
+    int advance, lsb;
+    stbtt_GetCodepointHMetrics(_fontinfo, c, &advance, &lsb);
+    result = floorf(advance*_vscale);
+    char2advance[c] = result;
   }
   return result;
 }
 
+float TruetypeFont::characterAdvance(uint32_t previousChar, uint32_t currentChar)
+{
+  // measuring text for line breaks must not rasterize glyphs, only glyphs that end up in a mesh are rendered
+  return advance(currentChar) + kerningOffset(previousChar, currentChar);
+}
+
 }
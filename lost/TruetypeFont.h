@@ -29,20 +29,29 @@ namespace lost
 struct TruetypeFont : public Font
 {
   TruetypeFont(const DataPtr& inData,
-              uint32_t inSizeInPoints);
+              uint32_t inSizeInPoints,
+              const GlyphAtlasPtr& inAtlas = GlyphAtlasPtr(), // creates its own atlas if none is given
+              bool inSignedDistanceField = false); // the atlas should use GL_LINEAR filtering for distance fields
   virtual ~TruetypeFont();
   GlyphPtr glyph(uint32_t utf32character);
   bool hasKerning();
   float kerningOffset(uint32_t previousChar, uint32_t currentChar);
   float characterAdvance(uint32_t previousChar, uint32_t currentChar); // returns advance (if glyph available)+kerningOffset (if kerning available), 0 otherwise. Use 0 if there is no prevchar
+  float advance(char32_t c); // horizontal metrics only, never rasterizes the glyph
+  void moveToCurrentPage(uint32_t utf32character);
+  
+  // distance fields are rasterized at sdfSize with a border of sdfSpread pixels, independent of the font size,
+  // so all sizes of a face can share them.
+  static const uint32_t sdfSize = 32;
+  static const uint32_t sdfSpread = 4;
   
   float             _vscale;
+  float             _sdfScale;
   struct stbtt_fontinfo*    _fontinfo;
   
   DataPtr _data;
   std::map<char32_t, GlyphPtr> char2glyph;
-  std::vector<GlyphPtr> glyphs; // this list of glyphs contains the glyphs in the order they were rendered
-  // this is important to preserve the ordering fo rth packing of the atlas
+  std::map<char32_t, float> char2advance; // line breaking measures many more characters than are drawn
   
   
   /** checks if the caches already contain the glyph for the given character 
@@ -50,7 +59,8 @@ struct TruetypeFont : public Font
    *  @return true if the glyph was rendered, false if it was cached and didn't need to be rendered again.
    */
   bool renderGlyph(char32_t c);
-  void rebuildTextureAtlas(); // builds a new texture atlas from the current glyphs in the cache.
+  BitmapPtr renderBitmap(char32_t c); // rasterizes the glyph for c in the format of the atlas
+  void addToAtlas(const GlyphPtr& glyph, char32_t c, uint32_t minPage = 0); // rasterizes and uploads the glyph, unless a shared distance field on minPage or later exists
   
 };
 
@@ -25,13 +25,28 @@ Uniform::Uniform()
   glType = 0;
   size = 0;
   location = 0;
+  stats = NULL;
+  shadowValid = false;
 }
 
 Uniform::Uniform(const string& inName, GLint inIndex, GLenum inGlType, GLint inSize, GLint loc)
-: name(inName), index(inIndex), glType(inGlType), size(inSize), location(loc)
+: name(inName), index(inIndex), glType(inGlType), size(inSize), location(loc), stats(NULL), shadowValid(false)
 {
 }
 
+bool Uniform::updateShadow(const void* data, u32 numBytes)
+{
+  if(shadowValid && (memcmp(&shadow, data, numBytes) == 0))
+  {
+    if(stats) { stats->skipped++; }
+    return false;
+  }
+  memcpy(&shadow, data, numBytes);
+  shadowValid = true;
+  if(stats) { stats->issued++; }
+  return true;
+}
+
 void Uniform::operator=(float v) { setFloat(v); }
 void Uniform::operator=(const Color& inCol) { set(inCol); }
 void Uniform::operator=(const Vec2& vec) { set(vec); }
@@ -41,25 +56,26 @@ void Uniform::operator=(GLint v) { setInt(v); }
 
 void Uniform::setInt(GLint inVal)
 {
-  glUniform1i(location, inVal);GLASSERT;
+  if(updateShadow(&inVal, sizeof(inVal))) { glUniform1i(location, inVal);GLASSERT; }
 }
 
 void Uniform::setFloat(float inVal)
 {
-  glUniform1f(location, inVal);GLASSERT;
+  if(updateShadow(&inVal, sizeof(inVal))) { glUniform1f(location, inVal);GLASSERT; }
 }
 
 void Uniform::setBool(bool inVal)
 {
-  glUniform1f(location, inVal);GLASSERT;
+  float v = inVal;
+  if(updateShadow(&v, sizeof(v))) { glUniform1f(location, v);GLASSERT; }
 }
 
 void Uniform::set(const Color& inCol)
 {
     switch(glType)
     {
-      case GL_FLOAT_VEC3: glUniform3f(location, inCol.r(), inCol.g(), inCol.b());GLASSERT;break;
-      case GL_FLOAT_VEC4: glUniform4f(location, inCol.r(), inCol.g(), inCol.b(), inCol.a());GLASSERT;break;
+      case GL_FLOAT_VEC3: if(updateShadow(inCol.fv, 3*sizeof(f32))) { glUniform3f(location, inCol.r(), inCol.g(), inCol.b());GLASSERT; } break;
+      case GL_FLOAT_VEC4: if(updateShadow(inCol.fv, 4*sizeof(f32))) { glUniform4f(location, inCol.r(), inCol.g(), inCol.b(), inCol.a());GLASSERT; } break;
       default: ASSERT(false,"type mismatch for: '"+name+"' required: "+enum2string(glType)+" was 'Color'");
     }
 }
@@ -68,8 +84,8 @@ void Uniform::set(const Vec4& vec)
 {
     switch(glType)
     {
-      case GL_FLOAT_VEC3: glUniform3f(location, vec.x, vec.y, vec.z);GLASSERT;break;
-      case GL_FLOAT_VEC4: glUniform4f(location, vec.x, vec.y, vec.z, vec.w);GLASSERT;break;
+      case GL_FLOAT_VEC3: if(updateShadow(&vec, 3*sizeof(f32))) { glUniform3f(location, vec.x, vec.y, vec.z);GLASSERT; } break;
+      case GL_FLOAT_VEC4: if(updateShadow(&vec, 4*sizeof(f32))) { glUniform4f(location, vec.x, vec.y, vec.z, vec.w);GLASSERT; } break;
       default: ASSERT(false, "type mismatch for: '"+name+"' required: "+enum2string(glType)+" was 'Vec4'");
     }
 }
@@ -78,7 +94,7 @@ void Uniform::set(const Vec2& inVec)
 {
     switch(glType)
     {
-      case GL_FLOAT_VEC2: glUniform2f(location, inVec.x, inVec.y);GLASSERT;break;
+      case GL_FLOAT_VEC2: if(updateShadow(&inVec, 2*sizeof(f32))) { glUniform2f(location, inVec.x, inVec.y);GLASSERT; } break;
       default: ASSERT(false, "type mismatch for: '"+name+"' required: "+enum2string(glType)+" was 'Vec2'");
     }
 }
@@ -87,7 +103,7 @@ void Uniform::set(const Vec3& inVec)
 {
     switch(glType)
     {
-      case GL_FLOAT_VEC3: glUniform3f(location, inVec.x, inVec.y, inVec.z);GLASSERT;break;
+      case GL_FLOAT_VEC3: if(updateShadow(&inVec, 3*sizeof(f32))) { glUniform3f(location, inVec.x, inVec.y, inVec.z);GLASSERT; } break;
       default: ASSERT(false, "type mismatch for: '"+name+"' required: "+enum2string(glType)+" was 'Vec3'");
     }
 }
@@ -96,7 +112,7 @@ void Uniform::set(const Matrix& mat)
 {
   switch(glType)
   {
-    case GL_FLOAT_MAT4: glUniformMatrix4fv(location, 1, GL_FALSE, mat.m);GLASSERT;break;
+    case GL_FLOAT_MAT4: if(updateShadow(mat.m, 16*sizeof(f32))) { glUniformMatrix4fv(location, 1, GL_FALSE, mat.m);GLASSERT; } break;
     default: ASSERT(false, "type mismatch for: '"+name+"' required: "+enum2string(glType)+" was 'Matrix'");
   }
 }
@@ -20,6 +20,14 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace lost
 {
 
+// counts how many uniform uploads were issued to GL and how many were skipped because the value was unchanged
+struct UniformStats
+{
+  UniformStats() : issued(0), skipped(0) {}
+  u32 issued;
+  u32 skipped;
+};
+
 struct Uniform
 {
   string     name;
@@ -27,6 +35,7 @@ struct Uniform
   GLenum          glType;     // numerical data type (int, float, bool etc.)
   GLint           size;       // size of array
   GLint           location;
+  UniformStats*   stats;      // owned by the ShaderProgram, may be NULL
 
   Uniform();
   Uniform(const string& inName,
@@ -50,6 +59,17 @@ struct Uniform
   void set(const Vec2& inVec);
   void set(const Vec3& inVec);
   void set(const Matrix& mat);
+
+private:
+  // last value uploaded to the program, large enough for a mat4
+  union
+  {
+    GLint i;
+    f32   f[16];
+  } shadow;
+  bool shadowValid;
+  
+  bool updateShadow(const void* data, u32 numBytes); // returns true if data differs from the last upload and needs to be sent to GL
 };
 
 }
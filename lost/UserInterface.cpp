@@ -66,6 +66,11 @@ void UserInterface::needsRedraw(Layer* layer)
   compositor->needsRedraw(layer);
 }
 
+void UserInterface::needsComposition(Layer* layer)
+{
+  compositor->needsComposition(layer);
+}
+
 void UserInterface::enable()
 {
   if(!rootView)
@@ -35,6 +35,7 @@ struct UserInterface
   
   // helper methods for views/layers so they don't need to access low level systems directly
   void needsRedraw(Layer* layer);
+  void needsComposition(Layer* layer);
   
   EventSystem* eventSystem;
   Compositor* compositor;
@@ -0,0 +1,47 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef LOST_VERTEXARRAY_H
+#define LOST_VERTEXARRAY_H
+
+#include "lost/BufferLayout.h"
+
+namespace lost
+{
+
+/** Vertex attributes of a vertex buffer, resolved against the attribute locations of a shader program.
+ *  Context creates one per (ShaderProgram, vertex buffer, index buffer) combination when they are drawn together for the first time.
+ *  If vertex array objects are available, the whole binding is recorded in vao, otherwise Context replays attributes on demand.
+ *  The vertex buffer's BufferLayout never changes for the lifetime of its GL buffer, so the buffer names are a sufficient key.
+ */
+struct VertexArray
+{
+  struct Attribute
+  {
+    GLuint                  location;
+    AttributePointerConfig  apc;
+  };
+  
+  VertexArray() : vao(0) {}
+  ~VertexArray() { if(vao) { deleteVertexArrays(1, &vao); } }
+  
+  GLuint            vao; // 0 if vertex array objects are not available
+  vector<Attribute> attributes;
+};
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2012 Tony Kostanjsek, Timo Boll
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef LOST_VERTEXLAYOUT_H
+#define LOST_VERTEXLAYOUT_H
+
+#include "lost/BufferLayout.h"
+#include "lost/HostBuffer.h"
+#include <type_traits>
+
+namespace lost
+{
+
+/** Compile time counterpart of BufferLayout.
+ *
+ *    typedef VertexLayout<Attr<UT_position, Vec2>, Attr<UT_texcoord0, Vec2> > Layout;
+ *
+ *    mesh->resetBuffers(Layout::bufferLayout(), ET_u16);
+ *    ...
+ *    StridedView<Vec2> pos = Layout::view<UT_position>(mesh->vertexBuffer->hostBuffer.get());
+ *    for(u32 i=0; i<pos.count; ++i) { pos[i] = ...; }
+ *    mesh->vertexBuffer->modified(0, pos.count);
+ *
+ *  Asking for a usage type that isn't part of the layout doesn't compile, and the element type of a view always matches
+ *  the C++ type, so there is no per element type dispatch like in HostBuffer::set.
+ *  Views write to the HostBuffer directly. Tell the HybridBuffer about modified elements so they get uploaded.
+ */
+
+// maps C++ types to ElementTypes. Types without a specialisation can't be used in a VertexLayout.
+template<typename T> struct ElementTypeFor;
+template<> struct ElementTypeFor<u8>     { static const ElementType value = ET_u8; };
+template<> struct ElementTypeFor<u16>    { static const ElementType value = ET_u16; };
+template<> struct ElementTypeFor<u32>    { static const ElementType value = ET_u32; };
+template<> struct ElementTypeFor<f32>    { static const ElementType value = ET_f32; };
+template<> struct ElementTypeFor<Vec2>   { static const ElementType value = ET_vec2_f32; };
+template<> struct ElementTypeFor<Vec3>   { static const ElementType value = ET_vec3_f32; };
+template<> struct ElementTypeFor<Vec4>   { static const ElementType value = ET_vec4_f32; };
+template<> struct ElementTypeFor<Color>  { static const ElementType value = ET_vec4_f32; };
+template<> struct ElementTypeFor<Matrix> { static const ElementType value = ET_mat4x4_f32; };
+
+template<UsageType UT, typename T>
+struct Attr
+{
+  static const UsageType usageType = UT;
+  typedef T Type;
+};
+
+// typed access to one attribute of all vertices in a buffer
+template<typename T>
+struct StridedView
+{
+  StridedView(uint8_t* inBase, uint32_t inStride, uint32_t inCount) : base(inBase), stride(inStride), count(inCount) {}
+  
+  T& operator[](uint32_t idx) { return *reinterpret_cast<T*>(base + stride*idx); }
+  const T& operator[](uint32_t idx) const { return *reinterpret_cast<const T*>(base + stride*idx); }
+  
+  uint8_t*  base; // first element
+  uint32_t  stride; // in bytes
+  uint32_t  count; // number of elements
+};
+
+// finds the Attr for a usage type, has no Type member if there is none
+template<UsageType UT, typename... Attrs> struct AttrFor {};
+template<UsageType UT, typename First, typename... Rest>
+struct AttrFor<UT, First, Rest...> : std::conditional<First::usageType == UT, First, AttrFor<UT, Rest...> >::type {};
+
+template<typename... Attrs>
+struct VertexLayout
+{
+  // runtime layout with the attributes in declaration order
+  static BufferLayout bufferLayout()
+  {
+    BufferLayout result;
+    int expand[] = {0, (result.add(ElementTypeFor<typename Attrs::Type>::value, Attrs::usageType), 0)...};
+    (void)expand;
+    return result;
+  }
+  
+  // true if a runtime layout has exactly these attributes, so views can be used on buffers with it
+  static bool matches(const BufferLayout& layout)
+  {
+    bool result = (layout.size() == bufferLayout().size());
+    int expand[] = {0, (result = result && layout.entries[Attrs::usageType].used && (layout.entries[Attrs::usageType].elementType == ElementTypeFor<typename Attrs::Type>::value), 0)...};
+    (void)expand;
+    return result;
+  }
+  
+  template<UsageType UT>
+  static StridedView<typename AttrFor<UT, Attrs...>::Type> view(HostBuffer* hb)
+  {
+    typedef typename AttrFor<UT, Attrs...>::Type T;
+    const BufferLayoutEntry& entry = hb->layout.entries[UT];
+    ASSERT(entry.used && (entry.elementType == ElementTypeFor<T>::value), "HostBuffer doesn't match VertexLayout for "<<nameForUsageType(UT));
+    return StridedView<T>(hb->buffer + entry.offset, hb->layout.size(), hb->count);
+  }
+};
+
+}
+
+#endif
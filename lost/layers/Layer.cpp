@@ -18,6 +18,11 @@ Layer::Layer()
   _borderWidth = 0;
   _opacity = 1.0f;
   _visible = true;
+  _z = 0;
+  _rootLayer = this;
+  _visibleWithinSuperlayers = true;
+  redrawGeneration = 0;
+  contentGeneration = 0;
   _backgroundContentMode = LayerContentModeScaleToFill;
   addDefaultKeyAccessors();
   addDefaultActions();
@@ -70,6 +75,10 @@ void Layer::addSublayer(const LayerPtr& layer)
     }
     layer->superlayer = this;
     sublayers.push_back(layer);
+    layer->updateHierarchyCache();
+    // redraws of layers outside the main hierarchy are dropped by the compositor, so a layer that was built
+    // while detached might not have a cache yet. this also recomposites this layer
+    layer->needsRedrawWithSublayers();
   }
   else
   {
@@ -85,6 +94,8 @@ void Layer::removeSublayer(const LayerPtr& layer)
     LayerPtr sublayer = *pos;
     sublayer->superlayer = NULL;
     sublayers.erase(pos);
+    sublayer->updateHierarchyCache();
+    needsComposition();
   }
   else
   {
@@ -106,8 +117,9 @@ void Layer::removeFromSuperlayer()
 
 void Layer::removeAllSublayers()
 {
-  for(const LayerPtr& layer : sublayers)
+  while(sublayers.size())
   {
+    LayerPtr layer = sublayers.back();
     removeSublayer(layer);
   }
 }
@@ -137,35 +149,48 @@ bool Layer::isSublayerOf(Layer* root)
 
 u16 Layer::z()
 {
-  u16 result = 0;
-  Layer* current = superlayer;
-  while(current)
+  return _z;
+}
+
+Layer* Layer::rootLayer()
+{
+  return _rootLayer;
+}
+
+void Layer::updateHierarchyCache()
+{
+  _z = superlayer ? superlayer->_z+1 : 0;
+  _rootLayer = superlayer ? superlayer->_rootLayer : this;
+  _visibleWithinSuperlayers = _visible && (superlayer ? superlayer->_visibleWithinSuperlayers : true);
+  for(const LayerPtr& layer : sublayers)
   {
-    ++result;
-    current = current->superlayer;
+    layer->updateHierarchyCache();
   }
-  return result;
 }
 
 #pragma mark - Visibility -
 
 bool Layer::isVisibleWithinSuperlayers()
 {
-  bool result = visible();
-  
-  Layer* l = this;
-  while (result && l)
-  {
-    result = l->visible();
-    l = l->superlayer;
-  }
-  
-  return result;
+  return _visibleWithinSuperlayers;
 }
 
 void Layer::visible(bool val)
 {
-  _visible = val;
+  if(_visible != val)
+  {
+    _visible = val;
+    updateHierarchyCache();
+    if(val)
+    {
+      // the compositor drops redraws of hidden layers, so the caches of this layer and its sublayers might be stale or missing
+      needsRedrawWithSublayers();
+    }
+    else if(superlayer)
+    {
+      superlayer->needsComposition();
+    }
+  }
 }
 
 bool Layer::visible()
@@ -180,6 +205,20 @@ void Layer::needsRedraw()
   Application::instance()->ui->needsRedraw(this);
 }
 
+void Layer::needsComposition()
+{
+  Application::instance()->ui->needsComposition(this);
+}
+
+void Layer::needsRedrawWithSublayers()
+{
+  needsRedraw();
+  for(const LayerPtr& layer : sublayers)
+  {
+    layer->needsRedrawWithSublayers();
+  }
+}
+
 void Layer::composite(bool v)
 {
   _composite = v;
@@ -194,6 +233,7 @@ bool Layer::composite()
 void Layer::draw(DrawContext* ctx)
 {
   // clear buffer in any case
+  ctx->flush();
   ctx->glContext->clearColor(Color(0,0,0,0));
   ctx->glContext->clear(GL_COLOR_BUFFER_BIT);
 
@@ -240,6 +280,11 @@ void Layer::draw(DrawContext* ctx)
   }
 }
 
+bool Layer::drawsContent()
+{
+  return (_backgroundColor != clearColor) || ((_borderColor != clearColor) && (_borderWidth > 0));
+}
+
 Rect Layer::calculateDrawRectFor(const Rect& originalRect, const ImagePtr& img, LayerContentMode mode)
 {
   Rect result = originalRect;
@@ -327,7 +372,7 @@ void Layer::rect(const Rect& r)
     }
     if(superlayer)
     {
-      superlayer->needsRedraw();
+      superlayer->needsComposition();
     }
   }
   _rect = r;
@@ -407,7 +452,7 @@ ImagePtr Layer::backgroundImage() const { return _backgroundImage; }
 void Layer::backgroundContentMode(LayerContentMode v) { _backgroundContentMode = v; needsRedraw(); }
 LayerContentMode Layer::backgroundContentMode() { return _backgroundContentMode; }
 
-void Layer::opacity(f32 v) { _opacity=v; if(superlayer) { superlayer->needsRedraw(); } };
+void Layer::opacity(f32 v) { _opacity=v; if(superlayer) { superlayer->needsComposition(); } };
 f32 Layer::opacity() const { return _opacity; }
 
 #pragma mark - hit test -
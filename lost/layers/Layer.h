@@ -28,16 +28,19 @@ struct Layer : enable_shared_from_this<Layer>
   void removeAllSublayers();
   bool isSublayer(const LayerPtr& layer);
   bool isSublayerOf(Layer* root); // return true if root is one of the superlayers of this layer
-  u16 z();
+  u16 z(); // depth in the layer tree, cached
+  Layer* rootLayer(); // topmost superlayer or this, cached
   
   
-  bool isVisibleWithinSuperlayers(); // returns visibility of this and all superlayers
+  bool isVisibleWithinSuperlayers(); // returns visibility of this and all superlayers, cached
   void visible(bool val); // sets this layers visibility flag
   bool visible(); // returns this layers visibility flag
   
   virtual void draw(DrawContext* ctx);
+  virtual bool drawsContent(); // false if draw() would leave the layer transparent, so the compositor can skip it. override together with draw()
   
   void needsRedraw(); // invalidate texture cache in compositor, force content redraw and composition
+  void needsComposition(); // only recomposite the cached sublayers, e.g. after they moved or faded. draw() is not called
   void composite(bool v);
   bool composite();
 
@@ -107,6 +110,9 @@ struct Layer : enable_shared_from_this<Layer>
   
   Layer* superlayer;
   vector<LayerPtr> sublayers;
+  
+  u32 redrawGeneration; // frame of the compositor the layer was last scheduled for composition in
+  u32 contentGeneration; // frame of the compositor the layers own drawing was last invalidated in
 
   void logTree();
 
@@ -123,6 +129,13 @@ private:
   Rect              _rect;
   bool              _visible;
   
+  // updated whenever the hierarchy or visibility changes, so the compositor doesn't have to walk up the tree for every layer
+  u16               _z;
+  Layer*            _rootLayer;
+  bool              _visibleWithinSuperlayers;
+  void updateHierarchyCache(); // updates this layer and all its sublayers
+  void needsRedrawWithSublayers(); // for layers that are added or shown, whose redraws the compositor dropped before
+  
   map<string, AnimationPtr> animations;
   vector<string> removeKeys;
   
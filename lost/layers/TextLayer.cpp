@@ -47,5 +47,10 @@ void TextLayer::draw(DrawContext* rc)
   }
 }
 
+bool TextLayer::drawsContent()
+{
+  return Layer::drawsContent() || (_font && _text.size());
+}
+
 }
 
@@ -31,6 +31,7 @@ struct TextLayer : public Layer
   string description();
   
   virtual void draw(DrawContext* rc);
+  virtual bool drawsContent();
 
 private:
   string        _text;
@@ -92,4 +92,128 @@ namespace lost
       }
     }
 
-}
\ No newline at end of file
+#pragma mark - Vertex Array Objects -
+
+#if (TARGET_OPENGL_ES && !(TARGET_IPHONE_SIMULATOR || TARGET_OS_IPHONE))
+  // OES_vertex_array_object entry points must be queried from EGL
+  typedef void (*GenVertexArraysFunc)(GLsizei n, GLuint* arrays);
+  typedef void (*BindVertexArrayFunc)(GLuint array);
+  typedef void (*DeleteVertexArraysFunc)(GLsizei n, const GLuint* arrays);
+
+  static GenVertexArraysFunc    _genVertexArrays = NULL;
+  static BindVertexArrayFunc    _bindVertexArray = NULL;
+  static DeleteVertexArraysFunc _deleteVertexArrays = NULL;
+#endif
+
+  bool hasExtension(const char* name)
+  {
+    const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if(!extensions)
+    {
+      return false;
+    }
+    
+    // match whole names only, a plain substring search would find e.g. GL_OES_texture_float in GL_OES_texture_float_linear
+    size_t length = strlen(name);
+    const char* pos = extensions;
+    while((pos = strstr(pos, name)))
+    {
+      bool startsName = (pos == extensions) || (*(pos-1) == ' ');
+      bool endsName = (pos[length] == ' ') || (pos[length] == 0);
+      if(startsName && endsName)
+      {
+        return true;
+      }
+      pos += length;
+    }
+    return false;
+  }
+
+  bool hasElementIndexUint()
+  {
+    static bool checked = false;
+    static bool result = false;
+    if(!checked)
+    {
+      checked = true;
+    #if TARGET_OPENGL_ES
+      result = hasExtension("GL_OES_element_index_uint");
+    #else
+      result = true;
+    #endif
+    }
+    return result;
+  }
+
+  bool hasVertexArrayObjects()
+  {
+    static bool checked = false;
+    static bool result = false;
+    if(!checked)
+    {
+      checked = true;
+    #if TARGET_IPHONE_SIMULATOR || TARGET_OS_IPHONE
+      result = hasExtension("GL_OES_vertex_array_object");
+    #elif TARGET_OPENGL_ES
+      if(hasExtension("GL_OES_vertex_array_object"))
+      {
+        _genVertexArrays = (GenVertexArraysFunc)eglGetProcAddress("glGenVertexArraysOES");
+        _bindVertexArray = (BindVertexArrayFunc)eglGetProcAddress("glBindVertexArrayOES");
+        _deleteVertexArrays = (DeleteVertexArraysFunc)eglGetProcAddress("glDeleteVertexArraysOES");
+        result = _genVertexArrays && _bindVertexArray && _deleteVertexArrays;
+      }
+    #elif defined __APPLE__
+      result = hasExtension("GL_APPLE_vertex_array_object");
+    #else
+      result = false;
+    #endif
+      DOUT("vertex array objects "<<(result ? "enabled" : "not available, using emulation"));
+    }
+    return result;
+  }
+
+  void genVertexArrays(GLsizei n, GLuint* arrays)
+  {
+  #if TARGET_IPHONE_SIMULATOR || TARGET_OS_IPHONE
+    glGenVertexArraysOES(n, arrays);GLDEBUG;
+  #elif TARGET_OPENGL_ES
+    _genVertexArrays(n, arrays);GLDEBUG;
+  #elif defined __APPLE__
+    glGenVertexArraysAPPLE(n, arrays);GLDEBUG;
+  #else
+    (void)n;
+    (void)arrays;
+    ASSERT(false, "vertex array objects are not available, check hasVertexArrayObjects() first");
+  #endif
+  }
+
+  void bindVertexArray(GLuint array)
+  {
+  #if TARGET_IPHONE_SIMULATOR || TARGET_OS_IPHONE
+    glBindVertexArrayOES(array);GLDEBUG;
+  #elif TARGET_OPENGL_ES
+    _bindVertexArray(array);GLDEBUG;
+  #elif defined __APPLE__
+    glBindVertexArrayAPPLE(array);GLDEBUG;
+  #else
+    (void)array;
+    ASSERT(false, "vertex array objects are not available, check hasVertexArrayObjects() first");
+  #endif
+  }
+
+  void deleteVertexArrays(GLsizei n, const GLuint* arrays)
+  {
+  #if TARGET_IPHONE_SIMULATOR || TARGET_OS_IPHONE
+    glDeleteVertexArraysOES(n, arrays);GLDEBUG;
+  #elif TARGET_OPENGL_ES
+    _deleteVertexArrays(n, arrays);GLDEBUG;
+  #elif defined __APPLE__
+    glDeleteVertexArraysAPPLE(n, arrays);GLDEBUG;
+  #else
+    (void)n;
+    (void)arrays;
+    ASSERT(false, "vertex array objects are not available, check hasVertexArrayObjects() first");
+  #endif
+  }
+
+}
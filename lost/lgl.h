@@ -62,6 +62,15 @@ namespace lost
 {
   lost::string getGlErrorAsString(GLenum err);
   lost::string enum2string(GLenum inVal);
+  bool hasExtension(const char* name); // true if name is one of the space separated names in GL_EXTENSIONS
+  bool hasElementIndexUint(); // true if glDrawElements accepts GL_UNSIGNED_INT indices, which OpenGL ES 2.0 only does with GL_OES_element_index_uint
+
+  // vertex array objects are an extension on OpenGL ES 2.0 and legacy desktop GL.
+  // Only call the functions below if hasVertexArrayObjects() returned true.
+  bool hasVertexArrayObjects();
+  void genVertexArrays(GLsizei n, GLuint* arrays);
+  void bindVertexArray(GLuint array);
+  void deleteVertexArrays(GLsizei n, const GLuint* arrays);
 }
   
 #if defined(LOST_GL_DEBUG)
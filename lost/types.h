@@ -74,10 +74,12 @@ namespace lost
   LE_SP(FragmentShader);
   LE_SP(Font);
   LE_SP(Glyph);
+  LE_SP(GlyphAtlas);
   LE_SP(TruetypeFont);
   LE_SP(TextMesh);
   LE_SP(Quad);
   LE_SP(FrameBuffer);
+  LE_SP(RenderTargetPool);
   LE_SP(Canvas);
   LE_SP(View);
   LE_SP(Layer);
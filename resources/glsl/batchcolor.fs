@@ -0,0 +1,6 @@
+varying vec4 vcolor;
+
+void main(void)
+{
+  gl_FragColor = vcolor;
+}
@@ -0,0 +1,14 @@
+uniform mat4 modelViewMatrix;  // mesh transform
+uniform mat4 projectionMatrix; // from camera
+
+attribute vec3 position;
+attribute vec4 color; // premultiplied per vertex color, set by QuadBatch
+
+varying vec4 vcolor;
+
+void main(void)
+{
+  vec4 pos = vec4(position, 1.0);
+  vcolor = color;
+  gl_Position = projectionMatrix*modelViewMatrix*pos; // equivalent to builtin function ftransform()
+}
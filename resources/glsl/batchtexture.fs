@@ -0,0 +1,8 @@
+varying vec2 vtexcoord0;
+varying vec4 vcolor;
+uniform sampler2D texture0;
+
+void main(void)
+{
+  gl_FragColor = vcolor*texture2D(texture0, vtexcoord0);
+}
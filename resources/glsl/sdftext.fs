@@ -0,0 +1,14 @@
+#ifdef GL_ES
+#extension GL_OES_standard_derivatives : enable
+#endif
+
+varying vec2 vtexcoord0;
+uniform vec4 color; // same semantics as gl_Color, premultiplied
+uniform sampler2D texture0; // distance field glyph atlas, .5 in the alpha channel is the edge of the glyph
+
+void main(void)
+{
+  float distance = texture2D(texture0, vtexcoord0).a;
+  float smoothing = fwidth(distance)*.5; // about half a pixel on screen, independent of the scale of the text
+  gl_FragColor = color*smoothstep(.5-smoothing, .5+smoothing, distance);
+}
@@ -0,0 +1,10 @@
+varying vec2 vtexcoord0;
+uniform vec4 color; // same semantics as gl_Color, premultiplied
+uniform sampler2D texture0; // distance field glyph atlas, .5 in the alpha channel is the edge of the glyph
+uniform float smoothing; // about half a pixel on screen in distance units, for GLES2 drivers without GL_OES_standard_derivatives
+
+void main(void)
+{
+  float distance = texture2D(texture0, vtexcoord0).a;
+  gl_FragColor = color*smoothstep(.5-smoothing, .5+smoothing, distance);
+}
@@ -0,0 +1,8 @@
+varying vec2 vtexcoord0;
+uniform vec4 color; // same semantics as gl_Color, premultiplied
+uniform sampler2D texture0; // glyph atlas, only the alpha channel holds the coverage
+
+void main(void)
+{
+  gl_FragColor = color*texture2D(texture0, vtexcoord0).a;
+}